@@ -0,0 +1,54 @@
+#include "Arena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+ScratchArena::ScratchArena(std::size_t initialBytes)
+    : block_(0), offset_(0), initialBytes_(std::max<std::size_t>(initialBytes, alignment)) {}
+
+// renvoie l'adresse alignée dans le bloc data à partir de offset, ou nullptr
+// si bytes ne tient pas ; offset est mis à jour en cas de succès
+static unsigned char* fitInBlock(unsigned char* data, std::size_t size,
+                                 std::size_t& offset, std::size_t bytes,
+                                 std::size_t alignment) {
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data);
+    std::uintptr_t p = (base + offset + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+    std::size_t start = static_cast<std::size_t>(p - base);
+    if (start > size || size - start < bytes)
+        return nullptr;
+    offset = start + bytes;
+    return data + start;
+}
+
+void* ScratchArena::allocateBytes(std::size_t bytes) {
+    // bloc courant, puis blocs suivants déjà possédés
+    for (; block_ < blocks_.size(); ++block_) {
+        Block& b = blocks_[block_];
+        if (unsigned char* p = fitInBlock(b.data.get(), b.size, offset_, bytes, alignment))
+            return p;
+        offset_ = 0;
+    }
+
+    // aucun bloc ne convient : on en ajoute un (taille doublée)
+    std::size_t size = blocks_.empty() ? initialBytes_ : 2 * blocks_.back().size;
+    size = std::max(size, bytes + alignment);
+    blocks_.push_back(Block{std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    block_ = blocks_.size() - 1;
+    offset_ = 0;
+    return fitInBlock(blocks_.back().data.get(), size, offset_, bytes, alignment);
+}
+
+void ScratchArena::release(Marker m) {
+    block_ = m.block;
+    offset_ = m.offset;
+}
+
+std::size_t ScratchArena::capacity() const {
+    std::size_t total = 0;
+    for (const Block& b : blocks_) total += b.size;
+    return total;
+}
+
+ScratchArena& ScratchArena::local() {
+    thread_local ScratchArena arena;
+    return arena;
+}
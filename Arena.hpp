@@ -0,0 +1,73 @@
+#ifndef _ARENA_
+#define _ARENA_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// ============ Arena de mémoire temporaire ================
+// Allocation par incrément de pointeur dans des blocs conservés d'un appel
+// à l'autre : après le premier pricing, les pricings de même taille ne
+// font plus aucune allocation sur le tas.
+// Réservée aux types triviaux (aucun destructeur n'est appelé).
+class ScratchArena {
+public:
+    struct Marker {
+        std::size_t block;
+        std::size_t offset;
+    };
+
+    // libère à la destruction tout ce qui a été alloué depuis la construction
+    class Scope {
+    private:
+        ScratchArena& arena_;
+        Marker mark_;
+
+    public:
+        explicit Scope(ScratchArena& arena) : arena_(arena), mark_(arena.mark()) {}
+        ~Scope() { arena_.release(mark_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    explicit ScratchArena(std::size_t initialBytes = 1 << 16);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // n éléments non initialisés, alignés sur une ligne de cache
+    template <typename T>
+    T* allocate(std::size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "ScratchArena only holds trivially destructible types");
+        return static_cast<T*>(allocateBytes(n * sizeof(T)));
+    }
+
+    Marker mark() const { return Marker{block_, offset_}; }
+    void release(Marker m);
+
+    // taille totale des blocs possédés (en octets)
+    std::size_t capacity() const;
+
+    // arena propre au thread appelant
+    static ScratchArena& local();
+
+private:
+    static constexpr std::size_t alignment = 64;
+
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t block_;
+    std::size_t offset_;
+    std::size_t initialBytes_;
+
+    void* allocateBytes(std::size_t bytes);
+};
+
+#endif
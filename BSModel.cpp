@@ -1,12 +1,243 @@
 #include "Model.hpp"
+#include "Arena.hpp"
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
 #include <stdexcept>
 #include <algorithm>
 
+// -------------------- Model --------------------
+
+// "name(p1,p2,...)", réels en hexadécimal (exacts)
+static std::string describeParameters(const char* name, std::initializer_list<double> params)
+{
+    std::ostringstream out;
+    out << name << '(' << std::hexfloat;
+    const char* sep = "";
+    for (double p : params) {
+        out << sep << p;
+        sep = ",";
+    }
+    out << ')';
+    return out.str();
+}
+
+void Model::generatePathWithVariance(double*, double*, double, double, int) const
+{
+    throw std::logic_error("This model does not provide step variances");
+}
+
+void Model::generatePathWithVariance(float*, float*, double, double, int) const
+{
+    throw std::logic_error("This model does not provide step variances");
+}
+
+// un path à la fois dans un buffer contigu, recopié à sa place dans le lot
+template <typename Real>
+static void generatePathsOneByOne(const Model& model, Real* paths, Real* stepVariance,
+                                  double S0, double T, int nSteps)
+{
+    const int batch = Model::batchPaths;
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    Real* path = arena.allocate<Real>(nSteps + 1);
+    Real* variance = stepVariance ? arena.allocate<Real>(nSteps) : nullptr;
+
+    for (int p = 0; p < batch; ++p) {
+        if (variance) {
+            model.generatePathWithVariance(path, variance, S0, T, nSteps);
+            for (int i = 0; i < nSteps; ++i) stepVariance[i * batch + p] = variance[i];
+        } else {
+            model.generatePath(path, S0, T, nSteps);
+        }
+        for (int i = 0; i <= nSteps; ++i) paths[i * batch + p] = path[i];
+    }
+}
+
+void Model::generatePaths(double* paths, double* stepVariance, double S0, double T, int nSteps) const
+{
+    generatePathsOneByOne(*this, paths, stepVariance, S0, T, nSteps);
+}
+
+void Model::generatePaths(float* paths, float* stepVariance, double S0, double T, int nSteps) const
+{
+    generatePathsOneByOne(*this, paths, stepVariance, S0, T, nSteps);
+}
+
+// -------------------- Tirages par lots --------------------
+// Noyaux des generatePaths : une boucle sur les batchPaths paths d'une date,
+// de longueur fixe, sans appel ni branchement, que le compilateur vectorise
+// (d'où les __restrict, et -fno-math-errno -fno-trapping-math dans le Makefile).
+// En double : exp/log/sin/cos de la libm. En float : polynômes de Cephes
+// (erreur relative ~1e-7, l'arrondi float), seuls vectorisables ; c'est
+// l'essentiel du gain du mode Float.
+
+namespace {
+
+constexpr int batch = Model::batchPaths;
+
+inline float bitsToFloat(std::int32_t i) { float f; std::memcpy(&f, &i, sizeof f); return f; }
+inline std::int32_t floatToBits(float f) { std::int32_t i; std::memcpy(&i, &f, sizeof i); return i; }
+
+// x arrondi à l'entier le plus proche (|x| < 2^22)
+inline float roundNearest(float x)
+{
+    const float magic = 12582912.0f;  // 1.5 * 2^23
+    return (x + magic) - magic;
+}
+
+inline double fastExp(double x) { return std::exp(x); }
+
+inline float fastExp(float x)
+{
+    x = std::min(std::max(x, -87.0f), 88.0f);
+    // 2^n lu dans les bits de t, sans conversion float -> int
+    const float magic = 12582912.0f;
+    const float t = x * 1.44269504088896341f + magic;
+    const float n = t - magic;
+    const float r = (x - n * 0.693359375f) + n * 2.12194440e-4f;  // x - n ln 2 en deux morceaux
+
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+    return p * bitsToFloat((floatToBits(t) - floatToBits(magic) + 127) << 23);
+}
+
+inline double fastLog(double x) { return std::log(x); }
+
+// x > 0 normalisé
+inline float fastLog(float x)
+{
+    const std::int32_t bits = floatToBits(x);
+    std::int32_t e = ((bits >> 23) & 0xff) - 126;
+    float m = bitsToFloat((bits & 0x007fffff) | 0x3f000000);  // mantisse dans [0.5, 1)
+    const bool low = m < 0.707106781186547524f;
+    e = low ? e - 1 : e;
+    m = low ? m + m - 1.0f : m - 1.0f;
+
+    const float z = m * m;
+    float y = 7.0376836292e-2f;
+    y = y * m - 1.1514610310e-1f;
+    y = y * m + 1.1676998740e-1f;
+    y = y * m - 1.2420140846e-1f;
+    y = y * m + 1.4249322787e-1f;
+    y = y * m - 1.6668057665e-1f;
+    y = y * m + 2.0000714765e-1f;
+    y = y * m - 2.4999993993e-1f;
+    y = y * m + 3.3333331174e-1f;
+    y = y * m * z;
+
+    const float fe = static_cast<float>(e);
+    y += fe * -2.12194440e-4f;
+    y += -0.5f * z;
+    return m + y + fe * 0.693359375f;
+}
+
+inline void sinCos2Pi(double u, double& c, double& s)
+{
+    const double a = 6.283185307179586 * u;
+    c = std::cos(a);
+    s = std::sin(a);
+}
+
+// cos et sin de 2 pi u, u dans [0, 1] : réduction au quart de tour le plus proche
+inline void sinCos2Pi(float u, float& c, float& s)
+{
+    const float y = 4.0f * (u - roundNearest(u));    // [-2, 2] quarts de tour
+    const float k = roundNearest(y);
+    const float a = (y - k) * 1.57079632679489662f;  // [-pi/4, pi/4]
+    const float a2 = a * a;
+
+    float sp = -1.9515295891e-4f;
+    sp = sp * a2 + 8.3321608736e-3f;
+    sp = sp * a2 - 1.6666654611e-1f;
+    const float sa = a + a * a2 * sp;
+
+    float cp = 2.443315711809948e-5f;
+    cp = cp * a2 - 1.388731625493765e-3f;
+    cp = cp * a2 + 4.166664568298827e-2f;
+    const float ca = 1.0f - 0.5f * a2 + a2 * a2 * cp;
+
+    // rotation de k quarts de tour
+    const std::int32_t q = static_cast<std::int32_t>(k) & 3;
+    const float c1 = (q & 1) ? -sa : ca;
+    const float s1 = (q & 1) ? ca : sa;
+    c = (q & 2) ? -c1 : c1;
+    s = (q & 2) ? -s1 : s1;
+}
+
+// batch gaussiennes par Box-Muller ; chaque tirage 64 bits donne les deux
+// uniformes (k + 1/2) / 2^32, identiques en double et en float
+template <typename Real>
+void gaussianBatch(std::mt19937_64& rng, std::uint64_t* __restrict bits, Real* __restrict z)
+{
+    const int half = batch / 2;
+    for (int k = 0; k < half; ++k) bits[k] = rng();
+
+    const Real scale = Real(1.0 / 4294967296.0);
+    for (int k = 0; k < half; ++k) {
+        const Real u1 = (static_cast<Real>(static_cast<std::uint32_t>(bits[k] >> 32)) + Real(0.5)) * scale;
+        const Real u2 = (static_cast<Real>(static_cast<std::uint32_t>(bits[k])) + Real(0.5)) * scale;
+        const Real radius = std::sqrt(Real(-2) * fastLog(u1));
+        Real c, s;
+        sinCos2Pi(u2, c, s);
+        z[k] = radius * c;
+        z[k + half] = radius * s;
+    }
+}
+
+// cur = prev * exp(drift + vol * z)
+template <typename Real>
+void logNormalStep(const Real* __restrict prev, Real* __restrict cur, const Real* __restrict z,
+                   Real drift, Real vol)
+{
+    for (int p = 0; p < batch; ++p)
+        cur[p] = prev[p] * fastExp(drift + vol * z[p]);
+}
+
+// pas du prix de Heston / LSV avec la variance instantanée var du début du
+// pas, partie positive (var+) : cur = prev * exp(r dt - var+ dt/2 + sqrt(var+ dt) z)
+// et stepVariance = var+ dt, variance exacte du pas simulé (pont brownien)
+template <typename Real>
+void stochasticVolStep(const Real* __restrict prev, Real* __restrict cur,
+                       Real* __restrict stepVariance, const Real* __restrict var,
+                       const Real* __restrict z, Real r, Real dt)
+{
+    for (int p = 0; p < batch; ++p) {
+        stepVariance[p] = std::max(var[p], Real(0)) * dt;
+        cur[p] = prev[p] * fastExp(r * dt - Real(0.5) * stepVariance[p] + std::sqrt(stepVariance[p]) * z[p]);
+    }
+}
+
+// pas d'Euler de la variance (CIR) en troncature complète : v peut devenir
+// négative, seule sa partie positive v+ entre dans le pas,
+// v += kappa (theta - v+) dt + xi sqrt(v+ dt) (rho z1 + sqrt(1 - rho^2) z2).
+// Tronquer v elle-même à 0 à chaque pas biaise la variance vers le haut quand
+// la condition de Feller n'est pas remplie, et les barrières avec.
+template <typename Real>
+void cirStep(Real* __restrict v, const Real* __restrict z1, const Real* __restrict z2,
+             Real kappa, Real theta, Real xi, Real rho, Real dt)
+{
+    const Real sqrtDt = std::sqrt(dt);
+    const Real rhoBar = std::sqrt(Real(1) - rho * rho);
+    for (int p = 0; p < batch; ++p) {
+        const Real w2 = rho * z1[p] + rhoBar * z2[p];
+        const Real vPlus = std::max(v[p], Real(0));
+        v[p] = v[p] + kappa * (theta - vPlus) * dt + xi * std::sqrt(vPlus) * sqrtDt * w2;
+    }
+}
+
+} // namespace
+
 // -------------------- BSModel --------------------
 
 BSModel::BSModel(double r, double sigma, unsigned long seed)
-    : r_(r), sigma_(sigma), rng_(seed), nd_(0.0, 1.0)
+    : r_(r), sigma_(sigma), seed_(seed), rng_(seed), nd_(0.0, 1.0)
 {
     if (sigma < 0.0) {
         throw std::invalid_argument("Volatility sigma must be non-negative");
@@ -17,10 +248,78 @@ BSModel::BSModel(double r, double sigma, unsigned long seed)
     }
 }
 
-void BSModel::generatePath(std::vector<double>& path,
+// Real = double ou float : les coefficients sont calculés en double puis
+// convertis, seule l'évolution du path se fait en Real
+template <typename Real>
+void BSModel::simulate(Real* path,
+                       Real* stepVariance,
+                       double S0,
+                       double T,
+                       int nSteps) const
+{
+    if (nSteps <= 0) {
+        throw std::invalid_argument("nSteps must be positive");
+    }
+    if (S0 <= 0.0) {
+        throw std::invalid_argument("Initial price S0 must be positive");
+    }
+    path[0] = static_cast<Real>(S0);
+
+    double dt = T / nSteps;
+    Real drift = static_cast<Real>((r_ - 0.5 * sigma_ * sigma_) * dt);
+    Real diffusion_coefficient = static_cast<Real>(sigma_ * std::sqrt(dt));
+
+    for (int i = 1; i <= nSteps; ++i) {
+        Real Z = static_cast<Real>(nd_(rng_));
+        path[i] = path[i-1] * std::exp(drift + diffusion_coefficient * Z);
+    }
+
+    if (stepVariance) {
+        const Real var = diffusion_coefficient * diffusion_coefficient;
+        for (int i = 0; i < nSteps; ++i) stepVariance[i] = var;
+    }
+}
+
+void BSModel::generatePath(double* path,
+                           double S0,
+                           double T,
+                           int nSteps) const
+{
+    simulate(path, static_cast<double*>(nullptr), S0, T, nSteps);
+}
+
+void BSModel::generatePathWithVariance(double* path,
+                                       double* stepVariance,
+                                       double S0,
+                                       double T,
+                                       int nSteps) const
+{
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+void BSModel::generatePath(float* path,
                            double S0,
                            double T,
                            int nSteps) const
+{
+    simulate(path, static_cast<float*>(nullptr), S0, T, nSteps);
+}
+
+void BSModel::generatePathWithVariance(float* path,
+                                       float* stepVariance,
+                                       double S0,
+                                       double T,
+                                       int nSteps) const
+{
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+template <typename Real>
+void BSModel::simulateBatch(Real* paths,
+                            Real* stepVariance,
+                            double S0,
+                            double T,
+                            int nSteps) const
 {
     if (nSteps <= 0) {
         throw std::invalid_argument("nSteps must be positive");
@@ -28,23 +327,54 @@ void BSModel::generatePath(std::vector<double>& path,
     if (S0 <= 0.0) {
         throw std::invalid_argument("Initial price S0 must be positive");
     }
-    path.resize(nSteps + 1);
-    path[0] = S0;
 
-    double dt = T / nSteps;
-    double drift = (r_ - 0.5 * sigma_ * sigma_) * dt;
-    double diffusion_coefficient = sigma_ * std::sqrt(dt);
+    const double dt = T / nSteps;
+    const Real drift = static_cast<Real>((r_ - 0.5 * sigma_ * sigma_) * dt);
+    const Real diffusion_coefficient = static_cast<Real>(sigma_ * std::sqrt(dt));
 
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    std::uint64_t* bits = arena.allocate<std::uint64_t>(batch / 2);
+    Real* z = arena.allocate<Real>(batch);
+
+    std::fill(paths, paths + batch, static_cast<Real>(S0));
     for (int i = 1; i <= nSteps; ++i) {
-        double Z = nd_(rng_);
-        path[i] = path[i-1] * std::exp(drift + diffusion_coefficient * Z);
+        gaussianBatch(rng_, bits, z);
+        logNormalStep(paths + (i - 1) * batch, paths + i * batch, z, drift, diffusion_coefficient);
+    }
+
+    if (stepVariance) {
+        const Real var = diffusion_coefficient * diffusion_coefficient;
+        std::fill(stepVariance, stepVariance + static_cast<std::size_t>(nSteps) * batch, var);
     }
 }
 
+void BSModel::generatePaths(double* paths, double* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void BSModel::generatePaths(float* paths, float* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void BSModel::reseed(unsigned long seed) const
+{
+    seed_ = seed;
+    rng_.seed(seed);
+    nd_.reset();
+}
+
+std::string BSModel::describe() const
+{
+    return describeParameters("BS", {r_, sigma_});
+}
+
 // -------------------- HESTON Model --------------------
 // Constructor
 HestonModel::HestonModel(double r, double kappa, double theta, double xi, double rho, unsigned long seed)
-    : r_(r), kappa_(kappa), theta_(theta), xi_(xi), rho_(rho), rng_(seed), nd_(0.0, 1.0)
+    : r_(r), kappa_(kappa), theta_(theta), xi_(xi), rho_(rho), seed_(seed), rng_(seed), nd_(0.0, 1.0)
 {
     if (kappa < 0.0)
         throw std::invalid_argument("Mean reversion kappa must be non-negative");
@@ -57,45 +387,174 @@ HestonModel::HestonModel(double r, double kappa, double theta, double xi, double
 }
 
 // Generate path for underlying price S_t, ignoring variance path return (could be extended)
-void HestonModel::generatePath(std::vector<double>& path,
-                              double S0,
-                              double T,
-                              int nSteps) const
+template <typename Real>
+void HestonModel::simulate(Real* path,
+                           Real* stepVariance,
+                           double S0,
+                           double T,
+                           int nSteps) const
 {
     if (nSteps <= 0)
         throw std::invalid_argument("nSteps must be positive");
     if (S0 <= 0.0)
         throw std::invalid_argument("Initial price S0 must be positive");
 
-    path.resize(nSteps + 1);
-    path[0] = S0;
+    path[0] = static_cast<Real>(S0);
 
-    double dt = T / nSteps;
-    double v = theta_;  // start variance at long-term mean
+    const Real dt = static_cast<Real>(T / nSteps);
+    const Real sqrtDt = std::sqrt(dt);
+    const Real r = static_cast<Real>(r_);
+    const Real kappa = static_cast<Real>(kappa_);
+    const Real theta = static_cast<Real>(theta_);
+    const Real xi = static_cast<Real>(xi_);
+    const Real rho = static_cast<Real>(rho_);
+    const Real rhoBar = std::sqrt(Real(1) - rho * rho);
+    Real v = theta;  // start variance at long-term mean
 
     for (int i = 1; i <= nSteps; ++i) {
         // Generate two correlated standard normals using Cholesky decomposition
+        Real Z1 = static_cast<Real>(nd_(rng_));
+        Real Z2 = static_cast<Real>(nd_(rng_));
+        Real W1 = Z1;
+        Real W2 = rho * Z1 + rhoBar * Z2;
+
+        // Underlying price process, with the variance at the start of the step
+        // (using the updated variance would correlate it with W1 and bias the drift)
+        Real vPlus = std::max(v, Real(0));
+        Real drift = (r - Real(0.5) * vPlus) * dt;
+        Real diffusion = std::sqrt(vPlus * dt) * W1;
+        path[i] = path[i-1] * std::exp(drift + diffusion);
+        if (stepVariance) stepVariance[i-1] = vPlus * dt;
+
+        // Variance process using Euler discretization (Cox-Ingersoll-Ross),
+        // full truncation: v may go negative, only its positive part is used
+        v = v + kappa * (theta - vPlus) * dt + xi * std::sqrt(vPlus) * sqrtDt * W2;
+    }
+}
+
+void HestonModel::generatePath(double* path,
+                               double S0,
+                               double T,
+                               int nSteps) const
+{
+    simulate(path, static_cast<double*>(nullptr), S0, T, nSteps);
+}
+
+void HestonModel::generatePathWithVariance(double* path,
+                                           double* stepVariance,
+                                           double S0,
+                                           double T,
+                                           int nSteps) const
+{
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+void HestonModel::generatePath(float* path,
+                               double S0,
+                               double T,
+                               int nSteps) const
+{
+    simulate(path, static_cast<float*>(nullptr), S0, T, nSteps);
+}
+
+void HestonModel::generatePathWithVariance(float* path,
+                                           float* stepVariance,
+                                           double S0,
+                                           double T,
+                                           int nSteps) const
+{
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+template <typename Real>
+void HestonModel::simulateBatch(Real* paths,
+                                Real* stepVariance,
+                                double S0,
+                                double T,
+                                int nSteps) const
+{
+    if (nSteps <= 0)
+        throw std::invalid_argument("nSteps must be positive");
+    if (S0 <= 0.0)
+        throw std::invalid_argument("Initial price S0 must be positive");
+
+    const Real dt = static_cast<Real>(T / nSteps);
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    std::uint64_t* bits = arena.allocate<std::uint64_t>(batch / 2);
+    Real* z1 = arena.allocate<Real>(batch);
+    Real* z2 = arena.allocate<Real>(batch);
+    Real* v = arena.allocate<Real>(batch);
+    Real* scratch = stepVariance ? nullptr : arena.allocate<Real>(batch);
+
+    std::fill(paths, paths + batch, static_cast<Real>(S0));
+    std::fill(v, v + batch, static_cast<Real>(theta_));  // v0 = theta
+    for (int i = 1; i <= nSteps; ++i) {
+        gaussianBatch(rng_, bits, z1);
+        gaussianBatch(rng_, bits, z2);
+        Real* var = stepVariance ? stepVariance + (i - 1) * batch : scratch;
+        stochasticVolStep(paths + (i - 1) * batch, paths + i * batch, var, v, z1,
+                          static_cast<Real>(r_), dt);
+        cirStep(v, z1, z2, static_cast<Real>(kappa_), static_cast<Real>(theta_),
+                static_cast<Real>(xi_), static_cast<Real>(rho_), dt);
+    }
+}
+
+void HestonModel::generatePaths(double* paths, double* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void HestonModel::generatePaths(float* paths, float* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void HestonModel::reseed(unsigned long seed) const
+{
+    seed_ = seed;
+    rng_.seed(seed);
+    nd_.reset();
+}
+
+std::string HestonModel::describe() const
+{
+    return describeParameters("Heston", {r_, kappa_, theta_, xi_, rho_});
+}
+
+void HestonModel::generateAssetAndVariancePaths(std::vector<double>& assetPath,
+                                                std::vector<double>& variancePath,
+                                                double S0,
+                                                double T,
+                                                int nSteps) const
+{
+    assetPath.resize(nSteps + 1);
+    variancePath.resize(nSteps + 1);
+
+    assetPath[0] = S0;
+    variancePath[0] = theta_;
+
+    double dt = T / nSteps;
+    double v = theta_;
+
+    for (int i = 1; i <= nSteps; ++i) {
         double Z1 = nd_(rng_);
         double Z2 = nd_(rng_);
         double W1 = Z1;
         double W2 = rho_ * Z1 + std::sqrt(1.0 - rho_ * rho_) * Z2;
 
-        // Variance process using Euler discretization (Cox-Ingersoll-Ross)
-        v = std::max(v + kappa_ * (theta_ - v) * dt + xi_ * std::sqrt(std::max(v, 0.0)) * std::sqrt(dt) * W2, 0.0);
+        double vPlus = std::max(v, 0.0);
+        double drift = (r_ - 0.5 * vPlus) * dt;
+        double diffusion = std::sqrt(vPlus * dt) * W1;
+        assetPath[i] = assetPath[i-1] * std::exp(drift + diffusion);
 
-        // Underlying price process
-        double drift = (r_ - 0.5 * v) * dt;
-        double diffusion = std::sqrt(v * dt) * W1;
-        path[i] = path[i-1] * std::exp(drift + diffusion);
+        // full truncation, as in simulate
+        v = v + kappa_ * (theta_ - vPlus) * dt + xi_ * std::sqrt(vPlus) * std::sqrt(dt) * W2;
+        variancePath[i] = std::max(v, 0.0);
     }
 }
 
-// Discount factor - same as BS model
-double HestonModel::discount(double T) const
-{
-    return std::exp(-r_ * T);
-}
-
 
 // -------------------- LSV Model --------------------
 // Constructor
@@ -103,7 +562,7 @@ LSVModel::LSVModel(double r, double kappa, double theta, double xi, double rho,
                    std::function<double(double,double)> sigmaLocal,
                    unsigned long seed)
     : r_(r), kappa_(kappa), theta_(theta), xi_(xi), rho_(rho),
-      sigmaLocal_(sigmaLocal), rng_(seed), nd_(0.0, 1.0)
+      sigmaLocal_(sigmaLocal), seed_(seed), rng_(seed), nd_(0.0, 1.0)
 {
     if (kappa < 0.0)
         throw std::invalid_argument("Mean reversion kappa must be non-negative");
@@ -116,50 +575,162 @@ LSVModel::LSVModel(double r, double kappa, double theta, double xi, double rho,
 }
 
 // Generate path with local volatility modulating stochastic volatility process
-void LSVModel::generatePath(std::vector<double>& path,
-                            double S0,
-                            double T,
-                            int nSteps) const
+template <typename Real>
+void LSVModel::simulate(Real* path,
+                        Real* stepVariance,
+                        double S0,
+                        double T,
+                        int nSteps) const
 {
     if (nSteps <= 0)
         throw std::invalid_argument("nSteps must be positive");
     if (S0 <= 0.0)
         throw std::invalid_argument("Initial price S0 must be positive");
 
-    path.resize(nSteps + 1);
-    path[0] = S0;
+    path[0] = static_cast<Real>(S0);
 
-    double dt = T / nSteps;
-    double v = theta_;  // start variance at long-term mean
+    const Real dt = static_cast<Real>(T / nSteps);
+    const Real sqrtDt = std::sqrt(dt);
+    const Real r = static_cast<Real>(r_);
+    const Real kappa = static_cast<Real>(kappa_);
+    const Real theta = static_cast<Real>(theta_);
+    const Real xi = static_cast<Real>(xi_);
+    const Real rho = static_cast<Real>(rho_);
+    const Real rhoBar = std::sqrt(Real(1) - rho * rho);
+    Real v = theta;  // start variance at long-term mean
 
+    // le temps est cumulé en double pour ne pas dériver sur les grilles fines
     double t = 0.0;
+    const double dtTime = T / nSteps;
 
     for (int i = 1; i <= nSteps; ++i) {
-        t += dt;
-
         // Generate correlated normals
-        double Z1 = nd_(rng_);
-        double Z2 = nd_(rng_);
-        double W1 = Z1;
-        double W2 = rho_ * Z1 + std::sqrt(1.0 - rho_ * rho_) * Z2;
-
-        // Update variance (CIR with Euler discretization)
-        v = std::max(v + kappa_ * (theta_ - v) * dt + xi_ * std::sqrt(std::max(v, 0.0)) * std::sqrt(dt) * W2, 0.0);
+        Real Z1 = static_cast<Real>(nd_(rng_));
+        Real Z2 = static_cast<Real>(nd_(rng_));
+        Real W1 = Z1;
+        Real W2 = rho * Z1 + rhoBar * Z2;
 
         // Local vol factor at current price and time
-        double sigma_loc = sigmaLocal_(path[i-1], t);
+        Real sigma_loc = static_cast<Real>(sigmaLocal_(path[i-1], t));
 
-        // Underlying price update with local stochastic vol
-        double drift = (r_ - 0.5 * v * sigma_loc * sigma_loc) * dt;
-        double diffusion = sigma_loc * std::sqrt(v * dt) * W1;
+        // Underlying price update with local stochastic vol (start-of-step variance)
+        Real vPlus = std::max(v, Real(0));
+        Real drift = (r - Real(0.5) * vPlus * sigma_loc * sigma_loc) * dt;
+        Real diffusion = sigma_loc * std::sqrt(vPlus * dt) * W1;
 
         path[i] = path[i-1] * std::exp(drift + diffusion);
+        if (stepVariance) stepVariance[i-1] = sigma_loc * sigma_loc * vPlus * dt;
+
+        // Update variance (CIR with Euler discretization, full truncation)
+        v = v + kappa * (theta - vPlus) * dt + xi * std::sqrt(vPlus) * sqrtDt * W2;
+        t += dtTime;
     }
 }
 
-double LSVModel::discount(double T) const
+void LSVModel::generatePath(double* path,
+                            double S0,
+                            double T,
+                            int nSteps) const
+{
+    simulate(path, static_cast<double*>(nullptr), S0, T, nSteps);
+}
+
+void LSVModel::generatePathWithVariance(double* path,
+                                        double* stepVariance,
+                                        double S0,
+                                        double T,
+                                        int nSteps) const
 {
-    return std::exp(-r_ * T);
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+void LSVModel::generatePath(float* path,
+                            double S0,
+                            double T,
+                            int nSteps) const
+{
+    simulate(path, static_cast<float*>(nullptr), S0, T, nSteps);
+}
+
+void LSVModel::generatePathWithVariance(float* path,
+                                        float* stepVariance,
+                                        double S0,
+                                        double T,
+                                        int nSteps) const
+{
+    simulate(path, stepVariance, S0, T, nSteps);
+}
+
+// la vol locale (std::function) est évaluée path par path ; le reste du pas
+// est vectorisé comme pour Heston
+template <typename Real>
+void LSVModel::simulateBatch(Real* paths,
+                             Real* stepVariance,
+                             double S0,
+                             double T,
+                             int nSteps) const
+{
+    if (nSteps <= 0)
+        throw std::invalid_argument("nSteps must be positive");
+    if (S0 <= 0.0)
+        throw std::invalid_argument("Initial price S0 must be positive");
+
+    const Real dt = static_cast<Real>(T / nSteps);
+    double t = 0.0;
+    const double dtTime = T / nSteps;
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    std::uint64_t* bits = arena.allocate<std::uint64_t>(batch / 2);
+    Real* z1 = arena.allocate<Real>(batch);
+    Real* z2 = arena.allocate<Real>(batch);
+    Real* v = arena.allocate<Real>(batch);
+    Real* localVar = arena.allocate<Real>(batch);
+    Real* scratch = stepVariance ? nullptr : arena.allocate<Real>(batch);
+
+    std::fill(paths, paths + batch, static_cast<Real>(S0));
+    std::fill(v, v + batch, static_cast<Real>(theta_));  // v0 = theta
+    for (int i = 1; i <= nSteps; ++i) {
+        gaussianBatch(rng_, bits, z1);
+        gaussianBatch(rng_, bits, z2);
+
+        const Real* prev = paths + (i - 1) * batch;
+        for (int p = 0; p < batch; ++p) {
+            const Real sigmaLoc = static_cast<Real>(sigmaLocal_(prev[p], t));
+            localVar[p] = sigmaLoc * sigmaLoc * v[p];
+        }
+
+        Real* var = stepVariance ? stepVariance + (i - 1) * batch : scratch;
+        stochasticVolStep(prev, paths + i * batch, var, localVar, z1,
+                          static_cast<Real>(r_), dt);
+        cirStep(v, z1, z2, static_cast<Real>(kappa_), static_cast<Real>(theta_),
+                static_cast<Real>(xi_), static_cast<Real>(rho_), dt);
+        t += dtTime;
+    }
+}
+
+void LSVModel::generatePaths(double* paths, double* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void LSVModel::generatePaths(float* paths, float* stepVariance, double S0, double T, int nSteps) const
+{
+    simulateBatch(paths, stepVariance, S0, T, nSteps);
+}
+
+void LSVModel::reseed(unsigned long seed) const
+{
+    seed_ = seed;
+    rng_.seed(seed);
+    nd_.reset();
+}
+
+std::string LSVModel::describe() const
+{
+    // sigmaLocal_ n'est pas descriptible : seule la sonde de
+    // PricingMC::fingerprint distingue deux fonctions de volatilité locale
+    return describeParameters("LSV", {r_, kappa_, theta_, xi_, rho_});
 }
 
 
@@ -167,8 +738,8 @@ double LSVModel::discount(double T) const
 // -------------------- BINOMIAL Model --------------------
 // Constructor
 
-BinomialModel::BinomialModel(double r, double sigma, int nSteps)
-    : r_(r), sigma_(sigma), nSteps_(nSteps)
+BinomialModel::BinomialModel(double r, double sigma, int nSteps, unsigned long seed)
+    : r_(r), sigma_(sigma), nSteps_(nSteps), seed_(seed), rng_(seed)
 {
     if (sigma < 0.0)
         throw std::invalid_argument("Volatility sigma must be non-negative");
@@ -176,10 +747,10 @@ BinomialModel::BinomialModel(double r, double sigma, int nSteps)
         throw std::invalid_argument("Number of steps must be positive");
 }
 
-void BinomialModel::generatePath(std::vector<double>& path,
-                                double S0,
-                                double T,
-                                int unused) const
+template <typename Real>
+void BinomialModel::simulate(Real* path,
+                             double S0,
+                             double T) const
 {
     // Note: generating a single path in a binomial model is less standard.
     // Here, generate one possible upward/downward path randomly.
@@ -187,8 +758,7 @@ void BinomialModel::generatePath(std::vector<double>& path,
     if (S0 <= 0.0)
         throw std::invalid_argument("Initial price S0 must be positive");
 
-    path.resize(nSteps_ + 1);
-    path[0] = S0;
+    path[0] = static_cast<Real>(S0);
 
     double dt = T / nSteps_;
     double u = std::exp(sigma_ * std::sqrt(dt));
@@ -199,16 +769,210 @@ void BinomialModel::generatePath(std::vector<double>& path,
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
 
     for (int i = 1; i <= nSteps_; ++i) {
-        double randVal = uniform(rng);
+        double randVal = uniform(rng_);
         if (randVal < p) {
-            path[i] = path[i-1] * u;  // up move
+            path[i] = path[i-1] * static_cast<Real>(u);  // up move
         } else {
-            path[i] = path[i-1] * d;  // down move
+            path[i] = path[i-1] * static_cast<Real>(d);  // down move
+        }
+    }
+}
+
+// le buffer est dimensionné par l'appelant : nSteps doit valoir nSteps_
+void BinomialModel::generatePath(double* path,
+                                 double S0,
+                                 double T,
+                                 int nSteps) const
+{
+    if (nSteps != nSteps_)
+        throw std::invalid_argument("nSteps must match the binomial tree size");
+    simulate(path, S0, T);
+}
+
+void BinomialModel::generatePath(float* path,
+                                 double S0,
+                                 double T,
+                                 int nSteps) const
+{
+    if (nSteps != nSteps_)
+        throw std::invalid_argument("nSteps must match the binomial tree size");
+    simulate(path, S0, T);
+}
+
+void BinomialModel::reseed(unsigned long seed) const
+{
+    seed_ = seed;
+    rng_.seed(seed);
+}
+
+std::string BinomialModel::describe() const
+{
+    return describeParameters("Binomial", {r_, sigma_, static_cast<double>(nSteps_)});
+}
+
+
+// -------------------- Multi-asset BS Model --------------------
+// Constructor
+
+MultiAssetBSModel::MultiAssetBSModel(double r,
+                                     const std::vector<double>& sigmas,
+                                     const std::vector<double>& correlation,
+                                     unsigned long seed)
+    : r_(r), sigmas_(sigmas), chol_(correlation.size(), 0.0),
+      seed_(seed), rng_(seed)
+{
+    const std::size_t d = sigmas.size();
+    if (d == 0)
+        throw std::invalid_argument("At least one asset is required");
+    if (correlation.size() != d * d)
+        throw std::invalid_argument("Correlation matrix must be nAssets x nAssets");
+    for (double s : sigmas) {
+        if (s < 0.0)
+            throw std::invalid_argument("Volatility sigma must be non-negative");
+    }
+    for (std::size_t i = 0; i < d; ++i) {
+        if (correlation[i * d + i] != 1.0)
+            throw std::invalid_argument("Correlation matrix must have a unit diagonal");
+        for (std::size_t j = 0; j < i; ++j) {
+            if (correlation[i * d + j] != correlation[j * d + i])
+                throw std::invalid_argument("Correlation matrix must be symmetric");
+        }
+    }
+
+    // Cholesky : correlation = L L^T
+    for (std::size_t i = 0; i < d; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            double sum = correlation[i * d + j];
+            for (std::size_t k = 0; k < j; ++k)
+                sum -= chol_[i * d + k] * chol_[j * d + k];
+            if (i == j) {
+                if (sum <= 0.0)
+                    throw std::invalid_argument("Correlation matrix must be positive definite");
+                chol_[i * d + i] = std::sqrt(sum);
+            } else {
+                chol_[i * d + j] = sum / chol_[j * d + j];
+            }
+        }
+    }
+}
+
+// W = Z * LsT pour un bloc de rows lignes : W[p][a] = sum_{k <= a} Z[p][k] * LsT[k][a].
+// La boucle interne parcourt a de façon contiguë (vectorisable) ; chaque
+// chargement de LsT[k][a] sert à quatre lignes à la fois.
+static void correlateBlock(const double* Z, double* W, int rows, int d, const double* LsT)
+{
+    std::fill(W, W + static_cast<std::size_t>(rows) * d, 0.0);
+    for (int k = 0; k < d; ++k) {
+        const double* lk = LsT + static_cast<std::size_t>(k) * d;
+        int p = 0;
+        for (; p + 4 <= rows; p += 4) {
+            const double z0 = Z[(p + 0) * d + k];
+            const double z1 = Z[(p + 1) * d + k];
+            const double z2 = Z[(p + 2) * d + k];
+            const double z3 = Z[(p + 3) * d + k];
+            double* w0 = W + (p + 0) * d;
+            double* w1 = W + (p + 1) * d;
+            double* w2 = W + (p + 2) * d;
+            double* w3 = W + (p + 3) * d;
+            for (int a = k; a < d; ++a) {
+                const double l = lk[a];
+                w0[a] += z0 * l;
+                w1[a] += z1 * l;
+                w2[a] += z2 * l;
+                w3[a] += z3 * l;
+            }
+        }
+        for (; p < rows; ++p) {
+            const double z = Z[p * d + k];
+            double* w = W + p * d;
+            for (int a = k; a < d; ++a)
+                w[a] += z * lk[a];
+        }
+    }
+}
+
+void MultiAssetBSModel::generatePaths(double* paths,
+                                      int nPaths,
+                                      const double* S0,
+                                      double T,
+                                      int nSteps) const
+{
+    if (nSteps <= 0)
+        throw std::invalid_argument("nSteps must be positive");
+    if (nPaths <= 0)
+        throw std::invalid_argument("nPaths must be positive");
+
+    const int d = nAssets();
+    for (int a = 0; a < d; ++a) {
+        if (S0[a] <= 0.0)
+            throw std::invalid_argument("Initial price S0 must be positive");
+    }
+
+    // paths traités par blocs de rowBlock : Z, W et les paths du bloc restent en cache
+    const int rowBlock = 32;
+    const std::size_t nTimes = static_cast<std::size_t>(nSteps) + 1;
+    const double dt = T / nSteps;
+    const double sqrtDt = std::sqrt(dt);
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    double* LsT = arena.allocate<double>(static_cast<std::size_t>(d) * d);
+    double* drift = arena.allocate<double>(d);
+    double* Z = arena.allocate<double>(static_cast<std::size_t>(rowBlock) * d);
+    double* W = arena.allocate<double>(static_cast<std::size_t>(rowBlock) * d);
+
+    // gaussiennes tirées par lots de gaussianBatch ; le reste d'un lot sert
+    // au pas suivant, aucun tirage n'est perdu
+    std::uint64_t* bits = arena.allocate<std::uint64_t>(batch / 2);
+    double* pool = arena.allocate<double>(batch);
+    int poolUsed = batch;
+    auto drawNormals = [&](double* z, int n) {
+        while (n > 0) {
+            if (poolUsed == batch) {
+                gaussianBatch(rng_, bits, pool);
+                poolUsed = 0;
+            }
+            const int k = std::min(n, batch - poolUsed);
+            std::copy(pool + poolUsed, pool + poolUsed + k, z);
+            poolUsed += k;
+            z += k;
+            n -= k;
+        }
+    };
+
+    // LsT[k][a] = sigma_a sqrt(dt) L[a][k]
+    for (int k = 0; k < d; ++k) {
+        for (int a = 0; a < d; ++a)
+            LsT[k * d + a] = (a >= k) ? sigmas_[a] * sqrtDt * chol_[a * d + k] : 0.0;
+    }
+    for (int a = 0; a < d; ++a)
+        drift[a] = (r_ - 0.5 * sigmas_[a] * sigmas_[a]) * dt;
+
+    for (int p0 = 0; p0 < nPaths; p0 += rowBlock) {
+        const int rows = std::min(rowBlock, nPaths - p0);
+
+        for (int p = 0; p < rows; ++p) {
+            double* path = paths + (p0 + p) * nTimes * d;
+            for (int a = 0; a < d; ++a) path[a] = S0[a];
+        }
+
+        for (int t = 1; t <= nSteps; ++t) {
+            drawNormals(Z, rows * d);
+            correlateBlock(Z, W, rows, d, LsT);
+
+            for (int p = 0; p < rows; ++p) {
+                double* cur = paths + ((p0 + p) * nTimes + t) * d;
+                const double* prev = cur - d;
+                const double* w = W + p * d;
+                for (int a = 0; a < d; ++a)
+                    cur[a] = prev[a] * std::exp(drift[a] + w[a]);
+            }
         }
     }
 }
 
-double BinomialModel::discount(double T) const
+void MultiAssetBSModel::reseed(unsigned long seed) const
 {
-    return std::exp(-r_ * T);
+    seed_ = seed;
+    rng_.seed(seed);
 }
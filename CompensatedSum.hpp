@@ -0,0 +1,24 @@
+#ifndef _COMPENSATED_SUM_
+#define _COMPENSATED_SUM_
+
+#include <cmath>
+
+// somme compensée (Neumaier) : l'erreur d'arrondi des additions est
+// conservée dans c, ce qui rend la somme insensible au nombre de termes
+struct CompensatedSum {
+    double sum = 0.0;
+    double c = 0.0;
+
+    void add(double x) {
+        double t = sum + x;
+        if (std::fabs(sum) >= std::fabs(x))
+            c += (sum - t) + x;
+        else
+            c += (x - t) + sum;
+        sum = t;
+    }
+
+    double value() const { return sum + c; }
+};
+
+#endif
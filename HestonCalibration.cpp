@@ -0,0 +1,354 @@
+#include "HestonCalibration.hpp"
+#include "Arena.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double bsCall(double S, double K, double r, double T, double sigma) {
+    double sq = sigma * std::sqrt(T);
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / sq;
+    return S * normalCdf(d1) - K * std::exp(-r * T) * normalCdf(d1 - sq);
+}
+
+double bsVega(double S, double K, double r, double T, double sigma) {
+    double sq = sigma * std::sqrt(T);
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / sq;
+    return S * std::sqrt(T) * std::exp(-0.5 * d1 * d1) / std::sqrt(2.0 * pi);
+}
+
+// noeuds et poids de Gauss-Legendre sur [a, b]
+void gaussLegendre(int n, double a, double b, std::vector<double>& x, std::vector<double>& w) {
+    x.assign(n, 0.0);
+    w.assign(n, 0.0);
+    const double mid = 0.5 * (b + a), half = 0.5 * (b - a);
+    for (int i = 0; i < (n + 1) / 2; ++i) {
+        double z = std::cos(pi * (i + 0.75) / (n + 0.5));
+        double dp = 0.0;
+        for (int it = 0; it < 100; ++it) {
+            double p0 = 1.0, p1 = 0.0;
+            for (int j = 0; j < n; ++j) {
+                double p2 = p1;
+                p1 = p0;
+                p0 = ((2.0 * j + 1.0) * z * p1 - j * p2) / (j + 1);
+            }
+            dp = n * (z * p0 - p1) / (z * z - 1.0);
+            double dz = p0 / dp;
+            z -= dz;
+            if (std::fabs(dz) < 1e-15) break;
+        }
+        x[i] = mid - half * z;
+        x[n - 1 - i] = mid + half * z;
+        w[i] = w[n - 1 - i] = 2.0 * half / ((1.0 - z * z) * dp * dp);
+    }
+}
+
+// E[exp(i z ln(S_T / F_T))] sous Heston avec v0 = theta
+// (formulation "little Heston trap", stable pour les grandes maturités)
+std::complex<double> hestonCF(std::complex<double> z, double T, const HestonParams& p) {
+    const std::complex<double> i(0.0, 1.0);
+    const double xi2 = p.xi * p.xi;
+    std::complex<double> a = p.kappa - p.rho * p.xi * i * z;
+    std::complex<double> d = std::sqrt(a * a + xi2 * (i * z + z * z));
+    std::complex<double> g = (a - d) / (a + d);
+    std::complex<double> e = std::exp(-d * T);
+    std::complex<double> C = p.kappa * p.theta / xi2
+                           * ((a - d) * T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+    std::complex<double> D = (a - d) / xi2 * (1.0 - e) / (1.0 - g * e);
+    return std::exp(C + D * p.theta);
+}
+
+// paramètres <-> variables non contraintes de l'optimiseur
+void toUnconstrained(const HestonParams& p, double y[4]) {
+    y[0] = std::log(p.kappa);
+    y[1] = std::log(p.theta);
+    y[2] = std::log(p.xi);
+    y[3] = std::atanh(std::max(-0.999, std::min(0.999, p.rho)));
+}
+
+HestonParams fromUnconstrained(const double y[4]) {
+    return HestonParams{std::exp(y[0]), std::exp(y[1]), std::exp(y[2]), std::tanh(y[3])};
+}
+
+// résout A x = b (4 x 4) par élimination de Gauss avec pivot partiel
+bool solve4(double A[4][4], double b[4], double x[4]) {
+    for (int c = 0; c < 4; ++c) {
+        int piv = c;
+        for (int r = c + 1; r < 4; ++r)
+            if (std::fabs(A[r][c]) > std::fabs(A[piv][c])) piv = r;
+        if (std::fabs(A[piv][c]) < 1e-300) return false;
+        std::swap(A[c], A[piv]);
+        std::swap(b[c], b[piv]);
+        for (int r = c + 1; r < 4; ++r) {
+            double f = A[r][c] / A[c][c];
+            for (int k = c; k < 4; ++k) A[r][k] -= f * A[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (int r = 3; r >= 0; --r) {
+        double s = b[r];
+        for (int k = r + 1; k < 4; ++k) s -= A[r][k] * x[k];
+        x[r] = s / A[r][r];
+    }
+    return true;
+}
+
+} // namespace
+
+// -------------------- HestonCalibrator --------------------
+
+HestonCalibrator::HestonCalibrator(double S0, double r, const std::vector<VolQuote>& quotes, int nodesPerPanel)
+    : S0_(S0), r_(r), quotes_(quotes), maxIterations(100), tolerance(1e-10), nThreads(0)
+{
+    if (S0 <= 0.0)
+        throw std::invalid_argument("Initial price S0 must be positive");
+    if (quotes.empty())
+        throw std::invalid_argument("At least one quote is required");
+    if (nodesPerPanel <= 0)
+        throw std::invalid_argument("Number of quadrature nodes must be positive");
+
+    // regroupement par maturité
+    std::map<double, std::vector<int>> byMaturity;
+    for (int q = 0; q < static_cast<int>(quotes_.size()); ++q) {
+        const VolQuote& v = quotes_[q];
+        if (v.strike <= 0.0 || v.maturity <= 0.0 || v.impliedVol <= 0.0 || v.weight < 0.0)
+            throw std::invalid_argument("Quotes need positive strike, maturity and volatility");
+        marketPrices_.push_back(bsCall(S0_, v.strike, r_, v.maturity, v.impliedVol));
+        vegas_.push_back(std::max(bsVega(S0_, v.strike, r_, v.maturity, v.impliedVol), 1e-4 * S0_));
+        byMaturity[v.maturity].push_back(q);
+    }
+
+    for (const auto& entry : byMaturity) {
+        Slice slice;
+        slice.T = entry.first;
+        slice.quotes = entry.second;
+
+        // troncature : l'intégrande décroît au moins comme exp(-sigma^2 T u^2 / 2) ;
+        // on prend la moitié de la plus petite vol de la maturité par prudence
+        double minVol = quotes_[slice.quotes.front()].impliedVol;
+        for (int q : slice.quotes) minVol = std::min(minVol, quotes_[q].impliedVol);
+        double sigmaRef = 0.5 * minVol;
+        double umax = std::sqrt(2.0 * 40.0 / (sigmaRef * sigmaRef * slice.T));
+        umax = std::min(std::max(umax, 50.0), 5000.0);
+
+        // panneaux géométriques [0, 0.5], [0.5, 1], [1, 2], ... jusqu'à umax :
+        // résout à la fois le pic de 1/(u^2 + 1/4) en 0 et la queue
+        std::vector<double> x, w;
+        for (double a = 0.0, b = 0.5; a < umax; a = b, b = std::min(2.0 * b, umax)) {
+            gaussLegendre(nodesPerPanel, a, b, x, w);
+            for (int j = 0; j < nodesPerPanel; ++j) {
+                slice.nodes.push_back(x[j]);
+                slice.weights.push_back(w[j] / (x[j] * x[j] + 0.25));
+            }
+        }
+        const int nNodes = static_cast<int>(slice.nodes.size());
+
+        slice.cosTable.resize(slice.quotes.size() * nNodes);
+        slice.sinTable.resize(slice.quotes.size() * nNodes);
+        for (std::size_t l = 0; l < slice.quotes.size(); ++l) {
+            double k = std::log(S0_ / quotes_[slice.quotes[l]].strike) + r_ * slice.T;
+            for (int j = 0; j < nNodes; ++j) {
+                slice.cosTable[l * nNodes + j] = std::cos(slice.nodes[j] * k);
+                slice.sinTable[l * nNodes + j] = std::sin(slice.nodes[j] * k);
+            }
+        }
+        slices_.push_back(std::move(slice));
+    }
+}
+
+// Lewis : C = S0 - sqrt(S0 K) e^{-rT/2} / pi * int_0^inf Re[e^{iuk} phi(u - i/2)] / (u^2 + 1/4) du,
+// k = ln(S0/K) + rT ; phi ne dépend pas du strike et est calculée une fois par jeu de paramètres
+void HestonCalibrator::slicePrices(const Slice& slice, const HestonParams* sets, int nSets, double* out) const {
+    const int N = static_cast<int>(slice.nodes.size());
+    const int nQuotes = static_cast<int>(quotes_.size());
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    double* re = arena.allocate<double>(N);
+    double* im = arena.allocate<double>(N);
+
+    for (int s = 0; s < nSets; ++s) {
+        for (int j = 0; j < N; ++j) {
+            std::complex<double> phi = hestonCF(std::complex<double>(slice.nodes[j], -0.5), slice.T, sets[s]);
+            re[j] = phi.real() * slice.weights[j];
+            im[j] = phi.imag() * slice.weights[j];
+        }
+
+        for (std::size_t l = 0; l < slice.quotes.size(); ++l) {
+            const double* c = slice.cosTable.data() + l * N;
+            const double* sn = slice.sinTable.data() + l * N;
+            double integral = 0.0;
+            for (int j = 0; j < N; ++j)
+                integral += c[j] * re[j] - sn[j] * im[j];
+
+            const int q = slice.quotes[l];
+            const double K = quotes_[q].strike;
+            out[s * nQuotes + q] = S0_ - std::sqrt(S0_ * K) * std::exp(-0.5 * r_ * slice.T) / pi * integral;
+        }
+    }
+}
+
+// les maturités sont réparties entre les threads ; chacun écrit des quotes distinctes
+void HestonCalibrator::prices(const HestonParams* sets, int nSets, double* out) const {
+    unsigned n = nThreads ? nThreads : std::max(1u, std::thread::hardware_concurrency());
+    n = std::min<unsigned>(n, static_cast<unsigned>(slices_.size()));
+
+    if (n <= 1) {
+        for (const Slice& slice : slices_)
+            slicePrices(slice, sets, nSets, out);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(n);
+    for (unsigned t = 0; t < n; ++t) {
+        workers.emplace_back([this, t, n, sets, nSets, out]() {
+            for (std::size_t i = t; i < slices_.size(); i += n)
+                slicePrices(slices_[i], sets, nSets, out);
+        });
+    }
+    for (std::thread& w : workers) w.join();
+}
+
+void HestonCalibrator::residuals(const HestonParams* sets, int nSets, double* out) const {
+    prices(sets, nSets, out);
+    const std::size_t nQuotes = quotes_.size();
+    for (int s = 0; s < nSets; ++s) {
+        for (std::size_t q = 0; q < nQuotes; ++q) {
+            double& x = out[s * nQuotes + q];
+            x = (x - marketPrices_[q]) / vegas_[q] * quotes_[q].weight;
+        }
+    }
+}
+
+std::vector<double> HestonCalibrator::modelPrices(const HestonParams& params) const {
+    std::vector<double> out(quotes_.size());
+    prices(&params, 1, out.data());
+    return out;
+}
+
+CalibrationResult HestonCalibrator::calibrate(const HestonParams& initial) const {
+    if (initial.kappa <= 0.0 || initial.theta <= 0.0 || initial.xi <= 0.0)
+        throw std::invalid_argument("Initial kappa, theta and xi must be positive");
+    if (initial.rho <= -1.0 || initial.rho >= 1.0)
+        throw std::invalid_argument("Initial rho must be in (-1,1)");
+
+    const std::size_t m = quotes_.size();
+    const double h = 1e-6;
+
+    double y[4];
+    toUnconstrained(initial, y);
+
+    // r : résidus courants ; J : jacobienne par différences avant, les 4
+    // jeux de paramètres bumpés étant évalués en un seul passage
+    std::vector<double> r(m), rTrial(m), bumped(4 * m), J(4 * m);
+    HestonParams base = fromUnconstrained(y);
+    residuals(&base, 1, r.data());
+
+    auto cost = [m](const std::vector<double>& v) {
+        double c = 0.0;
+        for (std::size_t i = 0; i < m; ++i) c += v[i] * v[i];
+        return 0.5 * c;
+    };
+    auto jacobian = [&]() {
+        HestonParams sets[4];
+        for (int k = 0; k < 4; ++k) {
+            double yk[4] = {y[0], y[1], y[2], y[3]};
+            yk[k] += h;
+            sets[k] = fromUnconstrained(yk);
+        }
+        residuals(sets, 4, bumped.data());
+        for (int k = 0; k < 4; ++k)
+            for (std::size_t i = 0; i < m; ++i)
+                J[k * m + i] = (bumped[k * m + i] - r[i]) / h;
+    };
+
+    double c = cost(r);
+    double lambda = 1e-3;
+    int iter = 0;
+    bool converged = false;
+    jacobian();
+
+    for (; iter < maxIterations && !converged; ++iter) {
+        double A[4][4], g[4];
+        for (int a = 0; a < 4; ++a) {
+            g[a] = 0.0;
+            for (std::size_t i = 0; i < m; ++i) g[a] += J[a * m + i] * r[i];
+            for (int b = 0; b < 4; ++b) {
+                double s = 0.0;
+                for (std::size_t i = 0; i < m; ++i) s += J[a * m + i] * J[b * m + i];
+                A[a][b] = s;
+            }
+        }
+
+        bool accepted = false;
+        while (!accepted && lambda < 1e12) {
+            double M[4][4], rhs[4], dy[4];
+            for (int a = 0; a < 4; ++a) {
+                for (int b = 0; b < 4; ++b) M[a][b] = A[a][b];
+                M[a][a] += lambda * std::max(A[a][a], 1e-12);
+                rhs[a] = -g[a];
+            }
+            if (!solve4(M, rhs, dy)) {
+                lambda *= 4.0;
+                continue;
+            }
+
+            double yTrial[4];
+            double stepNorm = 0.0;
+            for (int a = 0; a < 4; ++a) {
+                yTrial[a] = y[a] + dy[a];
+                stepNorm = std::max(stepNorm, std::fabs(dy[a]));
+            }
+            HestonParams trial = fromUnconstrained(yTrial);
+            residuals(&trial, 1, rTrial.data());
+            double cTrial = cost(rTrial);
+
+            if (std::isfinite(cTrial) && cTrial < c) {
+                accepted = true;
+                converged = (c - cTrial) <= tolerance * (1.0 + c) || stepNorm <= 1e-10;
+                std::copy(yTrial, yTrial + 4, y);
+                std::swap(r, rTrial);
+                c = cTrial;
+                lambda = std::max(lambda / 3.0, 1e-12);
+            } else {
+                lambda *= 4.0;
+            }
+        }
+
+        // aucun pas ne fait baisser le coût avant lambda = 1e12 : échec, pas
+        // convergence (converged reste faux) ; l'itération tentée est comptée
+        if (!accepted) {
+            ++iter;
+            break;
+        }
+        if (!converged)
+            jacobian();
+    }
+
+    CalibrationResult res;
+    res.params = fromUnconstrained(y);
+    res.rmse = std::sqrt(2.0 * c / static_cast<double>(m));
+    res.iterations = iter;
+    res.converged = converged;
+    return res;
+}
+
+CalibrationResult HestonCalibrator::calibrate(const HestonModel& previous) const {
+    return calibrate(HestonParams{previous.kappa(), previous.theta(), previous.xi(), previous.rho()});
+}
+
+HestonModel HestonCalibrator::model(const CalibrationResult& result, unsigned long seed) const {
+    const HestonParams& p = result.params;
+    return HestonModel(r_, p.kappa, p.theta, p.xi, p.rho, seed);
+}
@@ -0,0 +1,81 @@
+#ifndef _HESTON_CALIBRATION_
+#define _HESTON_CALIBRATION_
+
+#include <vector>
+#include "Model.hpp"
+
+// ============ Calibration de HestonModel sur une nappe de volatilité ================
+// Les prix de calls sont calculés par la formule de Lewis (fonction
+// caractéristique de Heston, quadrature de Gauss-Legendre) ; les termes qui
+// ne dépendent pas des paramètres (noeuds, poids, cos/sin(u k) par strike)
+// sont précalculés une fois, et la fonction caractéristique n'est évaluée
+// qu'une fois par maturité et partagée par tous les strikes de la maturité.
+// Optimisation par Levenberg-Marquardt, maturités évaluées en parallèle.
+// Comme dans HestonModel::generatePath, la variance initiale vaut theta.
+
+// un call européen coté en volatilité implicite Black-Scholes
+struct VolQuote {
+    double strike;
+    double maturity;
+    double impliedVol;
+    double weight = 1.0;
+};
+
+struct HestonParams {
+    double kappa;
+    double theta;
+    double xi;
+    double rho;
+};
+
+struct CalibrationResult {
+    HestonParams params;
+    double rmse;       // erreur quadratique moyenne pondérée, en volatilité (approx. prix / vega)
+    int iterations;
+    bool converged;
+};
+
+class HestonCalibrator {
+private:
+    struct Slice {
+        double T;
+        std::vector<int> quotes;       // indices dans quotes_
+        std::vector<double> nodes;     // u_j
+        std::vector<double> weights;   // w_j / (u_j^2 + 1/4)
+        std::vector<double> cosTable;  // cos(u_j k_q), quote par quote
+        std::vector<double> sinTable;  // sin(u_j k_q)
+    };
+
+    double S0_;
+    double r_;
+    std::vector<VolQuote> quotes_;
+    std::vector<double> marketPrices_;
+    std::vector<double> vegas_;
+    std::vector<Slice> slices_;
+
+    // prix modèle des quotes pour nSets jeux de paramètres : out[s * nQuotes + q]
+    void prices(const HestonParams* sets, int nSets, double* out) const;
+    void slicePrices(const Slice& slice, const HestonParams* sets, int nSets, double* out) const;
+
+    // (prix modèle - prix marché) / vega * poids, pour nSets jeux de paramètres
+    void residuals(const HestonParams* sets, int nSets, double* out) const;
+
+public:
+    int maxIterations;
+    double tolerance;
+    unsigned nThreads;  // 0 : std::thread::hardware_concurrency()
+
+    HestonCalibrator(double S0, double r, const std::vector<VolQuote>& quotes, int nodesPerPanel = 12);
+
+    // prix des calls de la nappe sous Heston (même noyau que la calibration)
+    std::vector<double> modelPrices(const HestonParams& params) const;
+
+    CalibrationResult calibrate(const HestonParams& initial) const;
+
+    // warm start depuis le modèle de la veille
+    CalibrationResult calibrate(const HestonModel& previous) const;
+
+    HestonModel model(const CalibrationResult& result, unsigned long seed = 42) const;
+};
+
+#endif
@@ -5,20 +5,58 @@
 #include <random>
 #include <cmath>
 #include <functional>
+#include <string>
 
 // ========= Abstract Class Model : =============
 class Model {
 public:
     virtual ~Model() = default;
 
-    // génère un path de taille nSteps+1 dans path (path doit être dimensionné)
-    virtual void generatePath(std::vector<double>& path,
+    // écrit un path de taille nSteps+1 dans path (buffer fourni par l'appelant)
+    virtual void generatePath(double* path,
                               double S0,
                               double T,
                               int nSteps) const = 0;
 
+    // même path en simple précision (mode Precision::Float de PricingMC) ;
+    // les tirages gaussiens sont identiques à la version double pour un même seed
+    virtual void generatePath(float* path,
+                              double S0,
+                              double T,
+                              int nSteps) const = 0;
+
+    // comme generatePath, et écrit dans stepVariance[i] (i = 0..nSteps-1) la
+    // variance du log-prix sur le pas i -> i+1 ; sert à la correction de pont
+    // brownien des barrières. Par défaut : non supporté.
+    virtual void generatePathWithVariance(double* path, double* stepVariance,
+                                          double S0, double T, int nSteps) const;
+    virtual void generatePathWithVariance(float* path, float* stepVariance,
+                                          double S0, double T, int nSteps) const;
+
+    // nombre de paths simulés ensemble par generatePaths
+    static constexpr int batchPaths = 256;
+
+    // simule batchPaths paths rangés date par date : paths[t * batchPaths + p]
+    // (t = 0..nSteps) ; si stepVariance n'est pas nul, stepVariance[i * batchPaths + p]
+    // reçoit la variance du log-prix du path p sur le pas i. Les boucles
+    // internes portent sur les paths et se vectorisent. Les tirages ne sont
+    // pas ceux de generatePath, mais sont identiques en double et en float.
+    // Par défaut : batchPaths appels à generatePath (ou generatePathWithVariance).
+    virtual void generatePaths(double* paths, double* stepVariance,
+                               double S0, double T, int nSteps) const;
+    virtual void generatePaths(float* paths, float* stepVariance,
+                               double S0, double T, int nSteps) const;
+
     // discount factor e^{-r T}
     virtual double discount(double T) const = 0;
+
+    // seed courant du générateur, et réinitialisation du générateur
+    virtual unsigned long seed() const = 0;
+    virtual void reseed(unsigned long seed) const = 0;
+
+    // type et paramètres du modèle, réels en hexadécimal (empreinte des
+    // shards) ; le seed n'en fait pas partie
+    virtual std::string describe() const = 0;
 };
 
 // ============== Class Model : =============
@@ -27,48 +65,78 @@ class BSModel : public Model {
 private:
     double r_;
     double sigma_;
+    mutable unsigned long seed_;
     mutable std::mt19937_64 rng_;
     mutable std::normal_distribution<double> nd_;
 
+    template <typename Real>
+    void simulate(Real* path, Real* stepVariance, double S0, double T, int nSteps) const;
+
+    template <typename Real>
+    void simulateBatch(Real* paths, Real* stepVariance, double S0, double T, int nSteps) const;
+
 public:
     BSModel(double r, double sigma, unsigned long seed = 42);
 
     double r() const { return r_; }
     double sigma() const { return sigma_; }
 
-    void generatePath(std::vector<double>& path,
+    void generatePath(double* path,
                       double S0,
                       double T,
                       int nSteps) const override;
+    void generatePath(float* path,
+                      double S0,
+                      double T,
+                      int nSteps) const override;
+    void generatePathWithVariance(double* path, double* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePathWithVariance(float* path, float* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePaths(double* paths, double* stepVariance,
+                       double S0, double T, int nSteps) const override;
+    void generatePaths(float* paths, float* stepVariance,
+                       double S0, double T, int nSteps) const override;
 
     double discount(double T) const override {
         return std::exp(-r_ * T);
     }
+
+    unsigned long seed() const override { return seed_; }
+    void reseed(unsigned long seed) const override;
+    std::string describe() const override;
 };
 
-#endif
 
 class BinomialModel : public Model {
 private:
     double r_;
     double sigma_;
     int nSteps_;
+    mutable unsigned long seed_;
     mutable std::mt19937_64 rng_;  // RNG member
 
+    template <typename Real>
+    void simulate(Real* path, double S0, double T) const;
+
 public:
-    BinomialModel(double r, double sigma, int nSteps);
+    BinomialModel(double r, double sigma, int nSteps, unsigned long seed = 42);
 
-    void generatePath(std::vector<double>& path, double S0, double T, int unused) const override;
+    void generatePath(double* path, double S0, double T, int nSteps) const override;
+    void generatePath(float* path, double S0, double T, int nSteps) const override;
 
     double discount(double T) const override { return std::exp(-r_ * T); }
 
+    unsigned long seed() const override { return seed_; }
+    void reseed(unsigned long seed) const override;
+    std::string describe() const override;
+
     // Additional methods for tree construction and option pricing via backward induction
     std::vector<std::vector<double>> buildPriceTree(double S0, double T) const;
 
     // (You may want a specialized method for option pricing rather than path generation)
 };
 
-#endif
 
 class LSVModel : public Model {
 private:
@@ -78,21 +146,46 @@ private:
     double xi_;
     double rho_;
 
+    std::function<double(double,double)> sigmaLocal_;  // local vol function sigma_loc(S,t)
+
+    mutable unsigned long seed_;
     mutable std::mt19937_64 rng_;
     mutable std::normal_distribution<double> nd_;
 
-    std::function<double(double,double)> sigmaLocal_;  // local vol function sigma_loc(S,t)
+    template <typename Real>
+    void simulate(Real* path, Real* stepVariance, double S0, double T, int nSteps) const;
+
+    template <typename Real>
+    void simulateBatch(Real* paths, Real* stepVariance, double S0, double T, int nSteps) const;
 
 public:
     LSVModel(double r, double kappa, double theta, double xi, double rho,
              std::function<double(double,double)> sigmaLocal,
              unsigned long seed);
 
-    void generatePath(std::vector<double>& path, double S0, double T, int nSteps) const override;
+    double r() const { return r_; }
+    double theta() const { return theta_; }
+    double xi() const { return xi_; }
+    const std::function<double(double,double)>& sigmaLocal() const { return sigmaLocal_; }
+
+    void generatePath(double* path, double S0, double T, int nSteps) const override;
+    void generatePath(float* path, double S0, double T, int nSteps) const override;
+    void generatePathWithVariance(double* path, double* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePathWithVariance(float* path, float* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePaths(double* paths, double* stepVariance,
+                       double S0, double T, int nSteps) const override;
+    void generatePaths(float* paths, float* stepVariance,
+                       double S0, double T, int nSteps) const override;
 
     double discount(double T) const override { return std::exp(-r_ * T); }
+
+    unsigned long seed() const override { return seed_; }
+    void reseed(unsigned long seed) const override;
+    std::string describe() const override;
 };
-#endif
+
 
 class HestonModel : public Model {
 private:
@@ -102,46 +195,110 @@ private:
     double xi_;
     double rho_;
 
+    mutable unsigned long seed_;
     mutable std::mt19937_64 rng_;
     mutable std::normal_distribution<double> nd_;
 
+    template <typename Real>
+    void simulate(Real* path, Real* stepVariance, double S0, double T, int nSteps) const;
+
+    template <typename Real>
+    void simulateBatch(Real* paths, Real* stepVariance, double S0, double T, int nSteps) const;
+
 public:
     HestonModel(double r, double kappa, double theta, double xi, double rho,
                 unsigned long seed);
 
-    void generatePath(std::vector<double>& path, double S0, double T, int nSteps) const override;
+    // la variance initiale des paths est theta (v0 = theta)
+    double r() const { return r_; }
+    double kappa() const { return kappa_; }
+    double theta() const { return theta_; }
+    double xi() const { return xi_; }
+    double rho() const { return rho_; }
+
+    void generatePath(double* path, double S0, double T, int nSteps) const override;
+    void generatePath(float* path, double S0, double T, int nSteps) const override;
+    void generatePathWithVariance(double* path, double* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePathWithVariance(float* path, float* stepVariance,
+                                  double S0, double T, int nSteps) const override;
+    void generatePaths(double* paths, double* stepVariance,
+                       double S0, double T, int nSteps) const override;
+    void generatePaths(float* paths, float* stepVariance,
+                       double S0, double T, int nSteps) const override;
 
     double discount(double T) const override { return std::exp(-r_ * T); }
 
-    void HestonModel::generateAssetAndVariancePaths(std::vector<double>& assetPath,
-                                               std::vector<double>& variancePath,
-                                               double S0,
-                                               double T,
-                                               int nSteps) const
-{
-    assetPath.resize(nSteps + 1);
-    variancePath.resize(nSteps + 1);
-
-    assetPath[0] = S0;
-    variancePath[0] = theta_;
-
-    double dt = T / nSteps;
-    double v = theta_;
-
-    for (int i = 1; i <= nSteps; ++i) {
-        double Z1 = nd_(rng_);
-        double Z2 = nd_(rng_);
-        double W1 = Z1;
-        double W2 = rho_ * Z1 + std::sqrt(1.0 - rho_ * rho_) * Z2;
-
-        v = std::max(v + kappa_ * (theta_ - v) * dt + xi_ * std::sqrt(std::max(v, 0.0)) * std::sqrt(dt) * W2, 0.0);
-        variancePath[i] = v;
-
-        double drift = (r_ - 0.5 * v) * dt;
-        double diffusion = std::sqrt(v * dt) * W1;
-        assetPath[i] = assetPath[i-1] * std::exp(drift + diffusion);
-    }
-}
+    unsigned long seed() const override { return seed_; }
+    void reseed(unsigned long seed) const override;
+    std::string describe() const override;
+
+    void generateAssetAndVariancePaths(std::vector<double>& assetPath,
+                                       std::vector<double>& variancePath,
+                                       double S0,
+                                       double T,
+                                       int nSteps) const;
+};
+
+
+// ========= Abstract Class MultiAssetModel : =============
+class MultiAssetModel {
+public:
+    virtual ~MultiAssetModel() = default;
+
+    virtual int nAssets() const = 0;
+
+    // génère nPaths paths de nSteps+1 dates pour les nAssets() sous-jacents
+    // (S0 de taille nAssets()), rangés path par path puis date par date :
+    // paths[(p * (nSteps+1) + t) * nAssets() + a]
+    virtual void generatePaths(double* paths,
+                               int nPaths,
+                               const double* S0,
+                               double T,
+                               int nSteps) const = 0;
+
+    virtual double discount(double T) const = 0;
+
+    virtual unsigned long seed() const = 0;
+    virtual void reseed(unsigned long seed) const = 0;
 };
 
-#endif
\ No newline at end of file
+
+// Black-Scholes multi-sous-jacents : dS_a / S_a = r dt + sigma_a dW_a,
+// corr(dW_a, dW_b) = rho_ab. La matrice de corrélation est factorisée une fois
+// (Cholesky) ; les incréments corrélés d'un lot de paths sont calculés
+// ensemble, comme un produit matriciel par blocs.
+class MultiAssetBSModel : public MultiAssetModel {
+private:
+    double r_;
+    std::vector<double> sigmas_;
+    std::vector<double> chol_;  // facteur de Cholesky L (d x d, row-major, triangulaire inférieur)
+
+    mutable unsigned long seed_;
+    mutable std::mt19937_64 rng_;  // tirages par lots (gaussianBatch)
+
+public:
+    // correlation : matrice d x d row-major, symétrique définie positive
+    MultiAssetBSModel(double r,
+                      const std::vector<double>& sigmas,
+                      const std::vector<double>& correlation,
+                      unsigned long seed = 42);
+
+    int nAssets() const override { return static_cast<int>(sigmas_.size()); }
+    double r() const { return r_; }
+    const std::vector<double>& sigmas() const { return sigmas_; }
+    const std::vector<double>& cholesky() const { return chol_; }
+
+    void generatePaths(double* paths,
+                       int nPaths,
+                       const double* S0,
+                       double T,
+                       int nSteps) const override;
+
+    double discount(double T) const override { return std::exp(-r_ * T); }
+
+    unsigned long seed() const override { return seed_; }
+    void reseed(unsigned long seed) const override;
+};
+
+#endif
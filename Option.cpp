@@ -1,181 +1,381 @@
 #include "Option.hpp"
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <stdexcept>
 
+// Chaque payoff est écrit une seule fois (evaluate<Real>) et exposé en
+// double et en float ; en float le strike est arrondi une fois à l'entrée.
+
+// "name(p1,p2,...)", réels en hexadécimal (exacts)
+static std::string describeParameters(const char* name, std::initializer_list<double> params) {
+    std::ostringstream out;
+    out << name << '(' << std::hexfloat;
+    const char* sep = "";
+    for (double p : params) {
+        out << sep << p;
+        sep = ",";
+    }
+    out << ')';
+    return out.str();
+}
+
 // =================== CallVanillaOption : ================
 CallVanillaOption::CallVanillaOption(double strike, double maturity)
-    : Option(maturity), K_(strike) {}
+    : Option(maturity), K_(strike) {
+    if (K_ <= 0.0)
+        throw std::invalid_argument("Strike must be positive");
+}
 
-double CallVanillaOption::payoff(const std::vector<double>& path) const {
+template <typename Real>
+Real CallVanillaOption::evaluate(PathView<Real> path) const {
     if (path.empty()) {
         throw std::invalid_argument("Path is empty");
     }
-    double S_T = path.back();  // final price on path
-    return std::max(S_T - K_, 0.0);
+    Real S_T = path.back();  // final price on path
+    return std::max(S_T - static_cast<Real>(K_), Real(0));
 }
 
+double CallVanillaOption::payoff(PathView<double> path) const { return evaluate(path); }
+float CallVanillaOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string CallVanillaOption::describe() const { return describeParameters("CallVanilla", {K_, T}); }
+
 // ==================== PutVanillaOption : =================
 PutVanillaOption::PutVanillaOption(double strike, double maturity)
-    : Option(maturity), K_(strike) {}
+    : Option(maturity), K_(strike) {
+    if (K_ <= 0.0)
+        throw std::invalid_argument("Strike must be positive");
+}
 
-double PutVanillaOption::payoff(const std::vector<double>& path) const {
+template <typename Real>
+Real PutVanillaOption::evaluate(PathView<Real> path) const {
     if (path.empty()) {
         throw std::invalid_argument("Path is empty");
     }
-    double S_T = path.back();
-    return std::max(K_ - S_T, 0.0);
+    Real S_T = path.back();
+    return std::max(static_cast<Real>(K_) - S_T, Real(0));
 }
 
+double PutVanillaOption::payoff(PathView<double> path) const { return evaluate(path); }
+float PutVanillaOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string PutVanillaOption::describe() const { return describeParameters("PutVanilla", {K_, T}); }
+
 // ==================== LookBackCallOption : =================
 LookBackCallOption::LookBackCallOption(double maturity)
     : Option(maturity) {}
 
-double LookBackCallOption::payoff(const std::vector<double>& path) const {
+template <typename Real>
+Real LookBackCallOption::evaluate(PathView<Real> path) const {
     if (path.empty()) {
         throw std::invalid_argument("Path is empty");
     }
-    double S_T = path.back();
-    double minPrice = *std::min_element(path.begin(), path.end());
-    return std::max(S_T - minPrice, 0.0);
+    Real S_T = path.back();
+    Real minPrice = path[0];
+    for (std::size_t i = 1; i < path.size(); ++i) minPrice = std::min(minPrice, path[i]);
+    return std::max(S_T - minPrice, Real(0));
 }
 
+double LookBackCallOption::payoff(PathView<double> path) const { return evaluate(path); }
+float LookBackCallOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string LookBackCallOption::describe() const { return describeParameters("LookBackCall", {T}); }
+
 // ==================== LookBackPutOption : =================
 LookBackPutOption::LookBackPutOption(double maturity)
     : Option(maturity) {}
 
-double LookBackPutOption::payoff(const std::vector<double>& path) const {
+template <typename Real>
+Real LookBackPutOption::evaluate(PathView<Real> path) const {
     if (path.empty()) {
         throw std::invalid_argument("Path is empty");
     }
-    double S_T = path.back();
-    double maxPrice = *std::max_element(path.begin(), path.end());
-    return std::max(maxPrice - S_T, 0.0);
-}
-// Digital Call Option
-class DigitalCallOption : public Option {
-private:
-    double K_;
-    double payout_;
-
-public:
-    DigitalCallOption(double strike, double maturity, double payout = 1.0)
-        : Option(maturity), K_(strike), payout_(payout) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-        return (path.back() > K_) ? payout_ : 0.0;
-    }
-};
-
-// Digital Call Option
-class DigitalCallOption : public Option {
-private:
-    double K_;
-    double payout_;
-
-public:
-    DigitalCallOption(double strike, double maturity, double payout = 1.0)
-        : Option(maturity), K_(strike), payout_(payout) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-        return (path.back() > K_) ? payout_ : 0.0;
+    Real S_T = path.back();
+    Real maxPrice = path[0];
+    for (std::size_t i = 1; i < path.size(); ++i) maxPrice = std::max(maxPrice, path[i]);
+    return std::max(maxPrice - S_T, Real(0));
+}
+
+double LookBackPutOption::payoff(PathView<double> path) const { return evaluate(path); }
+float LookBackPutOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string LookBackPutOption::describe() const { return describeParameters("LookBackPut", {T}); }
+
+// ==================== DigitalCallOption : =================
+DigitalCallOption::DigitalCallOption(double strike, double maturity, double payout)
+    : Option(maturity), K_(strike), payout_(payout) {}
+
+template <typename Real>
+Real DigitalCallOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    return (path.back() > static_cast<Real>(K_)) ? static_cast<Real>(payout_) : Real(0);
+}
+
+double DigitalCallOption::payoff(PathView<double> path) const { return evaluate(path); }
+float DigitalCallOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string DigitalCallOption::describe() const { return describeParameters("DigitalCall", {K_, payout_, T}); }
+
+// ==================== DigitalPutOption : =================
+DigitalPutOption::DigitalPutOption(double strike, double maturity, double payout)
+    : Option(maturity), K_(strike), payout_(payout) {}
+
+template <typename Real>
+Real DigitalPutOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    return (path.back() < static_cast<Real>(K_)) ? static_cast<Real>(payout_) : Real(0);
+}
+
+double DigitalPutOption::payoff(PathView<double> path) const { return evaluate(path); }
+float DigitalPutOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string DigitalPutOption::describe() const { return describeParameters("DigitalPut", {K_, payout_, T}); }
+
+// ==================== AsianCallOption / AsianPutOption : =================
+template <typename Real>
+static Real pathAverage(PathView<Real> path, AsianType type) {
+    const std::size_t n = path.size();
+    if (type == AsianType::Arithmetic) {
+        Real sum = 0;
+        for (std::size_t i = 0; i < n; ++i) sum += path[i];
+        return sum / static_cast<Real>(n);
     }
-};
-
-// Digital Put Option
-class DigitalPutOption : public Option {
-private:
-    double K_;
-    double payout_;
-
-public:
-    DigitalPutOption(double strike, double maturity, double payout = 1.0)
-        : Option(maturity), K_(strike), payout_(payout) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-        return (path.back() < K_) ? payout_ : 0.0;
+    Real sumLog = 0;
+    for (std::size_t i = 0; i < n; ++i) sumLog += std::log(path[i]);
+    return std::exp(sumLog / static_cast<Real>(n));
+}
+
+AsianCallOption::AsianCallOption(double strike, double maturity, AsianType type)
+    : Option(maturity), K_(strike), type_(type) {}
+
+template <typename Real>
+Real AsianCallOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    Real avg = pathAverage(path, type_);
+    return std::max(avg - static_cast<Real>(K_), Real(0));
+}
+
+double AsianCallOption::payoff(PathView<double> path) const { return evaluate(path); }
+float AsianCallOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string AsianCallOption::describe() const {
+    return describeParameters("AsianCall", {K_, static_cast<double>(type_), T});
+}
+
+AsianPutOption::AsianPutOption(double strike, double maturity, AsianType type)
+    : Option(maturity), K_(strike), type_(type) {}
+
+template <typename Real>
+Real AsianPutOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    Real avg = pathAverage(path, type_);
+    return std::max(static_cast<Real>(K_) - avg, Real(0));
+}
+
+double AsianPutOption::payoff(PathView<double> path) const { return evaluate(path); }
+float AsianPutOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string AsianPutOption::describe() const {
+    return describeParameters("AsianPut", {K_, static_cast<double>(type_), T});
+}
+
+// ==================== AmericanCallOption : =================
+AmericanCallOption::AmericanCallOption(double strike, double maturity)
+    : Option(maturity), K_(strike) {}
+
+template <typename Real>
+Real AmericanCallOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+
+    const Real K = static_cast<Real>(K_);
+    Real maxPayoff = 0;
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        Real price = path[i];
+        Real intrinsic = std::max(price - K, Real(0));
+        if (intrinsic > maxPayoff) maxPayoff = intrinsic;
     }
-};
-
-// Asian Call Option
-class AsianCallOption : public Option {
-private:
-    double K_;
-
-public:
-    AsianCallOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-        double avg = std::accumulate(path.begin(), path.end(), 0.0) / path.size();
-        return std::max(avg - K_, 0.0);
+    return maxPayoff;
+}
+
+double AmericanCallOption::payoff(PathView<double> path) const { return evaluate(path); }
+float AmericanCallOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string AmericanCallOption::describe() const { return describeParameters("AmericanCall", {K_, T}); }
+
+// ==================== AmericanPutOption : =================
+AmericanPutOption::AmericanPutOption(double strike, double maturity)
+    : Option(maturity), K_(strike) {}
+
+template <typename Real>
+Real AmericanPutOption::evaluate(PathView<Real> path) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+
+    const Real K = static_cast<Real>(K_);
+    Real maxPayoff = 0;
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        Real price = path[i];
+        Real intrinsic = std::max(K - price, Real(0));
+        if (intrinsic > maxPayoff) maxPayoff = intrinsic;
     }
-};
-
-// Asian Put Option
-class AsianPutOption : public Option {
-private:
-    double K_;
-
-public:
-    AsianPutOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-        double avg = std::accumulate(path.begin(), path.end(), 0.0) / path.size();
-        return std::max(K_ - avg, 0.0);
+    return maxPayoff;
+}
+
+double AmericanPutOption::payoff(PathView<double> path) const { return evaluate(path); }
+float AmericanPutOption::payoff(PathView<float> path) const { return evaluate(path); }
+std::string AmericanPutOption::describe() const { return describeParameters("AmericanPut", {K_, T}); }
+
+// ==================== BarrierOption : =================
+BarrierOption::BarrierOption(double strike, double barrier, double maturity, BarrierType type)
+    : Option(maturity), K_(strike), B_(barrier), type_(type) {
+    if (K_ <= 0.0)
+        throw std::invalid_argument("Strike must be positive");
+    if (B_ <= 0.0)
+        throw std::invalid_argument("Barrier must be positive");
+}
+
+// Entre S_i et S_{i+1} tous deux du bon côté de B, le pont brownien du
+// log-prix touche B avec la probabilité exp(-2 ln(S_i/B) ln(S_{i+1}/B) / var_i).
+template <typename Real>
+Real BarrierOption::survival(PathView<Real> path, PathView<Real> stepVariance) const {
+    const Real B = static_cast<Real>(B_);
+    const bool up = isUp();
+    const std::size_t n = path.size();
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (up ? path[i] >= B : path[i] <= B)
+            return Real(0);
     }
-};
-
-// American Call Option (approximates payoff by max intrinsic over path)
-class AmericanCallOption : public Option {
-private:
-    double K_;
-
-public:
-    AmericanCallOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-
-        double maxPayoff = 0.0;
-        for (double price : path) {
-            double intrinsic = std::max(price - K_, 0.0);
-            if (intrinsic > maxPayoff) maxPayoff = intrinsic;
-        }
-        return maxPayoff;
+    if (stepVariance.empty())
+        return Real(1);
+    if (stepVariance.size() + 1 < n)
+        throw std::invalid_argument("Step variance path is too short");
+
+    Real surv = 1;
+    Real a = std::log(path[0] / B);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        Real b = std::log(path[i + 1] / B);
+        Real var = stepVariance[i];
+        if (var > Real(0))
+            surv *= Real(1) - std::exp(Real(-2) * a * b / var);
+        a = b;
     }
-};
-
-// American Put Option (approximates payoff by max intrinsic over path)
-class AmericanPutOption : public Option {
-private:
-    double K_;
-
-public:
-    AmericanPutOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Path is empty");
-
-        double maxPayoff = 0.0;
-        for (double price : path) {
-            double intrinsic = std::max(K_ - price, 0.0);
-            if (intrinsic > maxPayoff) maxPayoff = intrinsic;
-        }
-        return maxPayoff;
+    return surv;
+}
+
+// ==================== BarrierCallOption : =================
+BarrierCallOption::BarrierCallOption(double strike, double barrier, double maturity, BarrierType type)
+    : BarrierOption(strike, barrier, maturity, type) {}
+
+template <typename Real>
+Real BarrierCallOption::evaluate(PathView<Real> path, PathView<Real> stepVariance) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    Real vanilla = std::max(path.back() - static_cast<Real>(K_), Real(0));
+    if (vanilla == Real(0))
+        return Real(0);
+    Real surv = survival(path, stepVariance);
+    return isKnockOut() ? vanilla * surv : vanilla * (Real(1) - surv);
+}
+
+double BarrierCallOption::payoff(PathView<double> path) const {
+    return evaluate(path, PathView<double>(nullptr, 0));
+}
+float BarrierCallOption::payoff(PathView<float> path) const {
+    return evaluate(path, PathView<float>(nullptr, 0));
+}
+std::string BarrierCallOption::describe() const {
+    return describeParameters("BarrierCall", {K_, B_, static_cast<double>(type_), T});
+}
+double BarrierCallOption::bridgedPayoff(PathView<double> path, PathView<double> stepVariance) const {
+    return evaluate(path, stepVariance);
+}
+float BarrierCallOption::bridgedPayoff(PathView<float> path, PathView<float> stepVariance) const {
+    return evaluate(path, stepVariance);
+}
+
+// ==================== BarrierPutOption : =================
+BarrierPutOption::BarrierPutOption(double strike, double barrier, double maturity, BarrierType type)
+    : BarrierOption(strike, barrier, maturity, type) {}
+
+template <typename Real>
+Real BarrierPutOption::evaluate(PathView<Real> path, PathView<Real> stepVariance) const {
+    if (path.empty())
+        throw std::invalid_argument("Path is empty");
+    Real vanilla = std::max(static_cast<Real>(K_) - path.back(), Real(0));
+    if (vanilla == Real(0))
+        return Real(0);
+    Real surv = survival(path, stepVariance);
+    return isKnockOut() ? vanilla * surv : vanilla * (Real(1) - surv);
+}
+
+double BarrierPutOption::payoff(PathView<double> path) const {
+    return evaluate(path, PathView<double>(nullptr, 0));
+}
+float BarrierPutOption::payoff(PathView<float> path) const {
+    return evaluate(path, PathView<float>(nullptr, 0));
+}
+std::string BarrierPutOption::describe() const {
+    return describeParameters("BarrierPut", {K_, B_, static_cast<double>(type_), T});
+}
+double BarrierPutOption::bridgedPayoff(PathView<double> path, PathView<double> stepVariance) const {
+    return evaluate(path, stepVariance);
+}
+float BarrierPutOption::bridgedPayoff(PathView<float> path, PathView<float> stepVariance) const {
+    return evaluate(path, stepVariance);
+}
+
+// ==================== BasketCallOption / BasketPutOption : =================
+static double basketValue(const MultiPathView& paths, const std::vector<double>& weights) {
+    if (paths.nTimes() == 0)
+        throw std::invalid_argument("Path is empty");
+    if (paths.nAssets() != static_cast<int>(weights.size()))
+        throw std::invalid_argument("Basket weights do not match the number of assets");
+    double basket = 0.0;
+    for (int a = 0; a < paths.nAssets(); ++a)
+        basket += weights[a] * paths.terminal(a);
+    return basket;
+}
+
+BasketCallOption::BasketCallOption(const std::vector<double>& weights, double strike, double maturity)
+    : MultiAssetOption(maturity), weights_(weights), K_(strike) {
+    if (weights_.empty())
+        throw std::invalid_argument("Basket must contain at least one asset");
+}
+
+double BasketCallOption::payoff(const MultiPathView& paths) const {
+    return std::max(basketValue(paths, weights_) - K_, 0.0);
+}
+
+BasketPutOption::BasketPutOption(const std::vector<double>& weights, double strike, double maturity)
+    : MultiAssetOption(maturity), weights_(weights), K_(strike) {
+    if (weights_.empty())
+        throw std::invalid_argument("Basket must contain at least one asset");
+}
+
+double BasketPutOption::payoff(const MultiPathView& paths) const {
+    return std::max(K_ - basketValue(paths, weights_), 0.0);
+}
+
+// ==================== RainbowCallOption / RainbowPutOption : =================
+static double rainbowValue(const MultiPathView& paths, RainbowType type) {
+    if (paths.nTimes() == 0 || paths.nAssets() == 0)
+        throw std::invalid_argument("Path is empty");
+    double value = paths.terminal(0);
+    for (int a = 1; a < paths.nAssets(); ++a) {
+        double S = paths.terminal(a);
+        value = (type == RainbowType::BestOf) ? std::max(value, S) : std::min(value, S);
     }
-};
+    return value;
+}
+
+RainbowCallOption::RainbowCallOption(double strike, double maturity, RainbowType type)
+    : MultiAssetOption(maturity), K_(strike), type_(type) {}
+
+double RainbowCallOption::payoff(const MultiPathView& paths) const {
+    return std::max(rainbowValue(paths, type_) - K_, 0.0);
+}
+
+RainbowPutOption::RainbowPutOption(double strike, double maturity, RainbowType type)
+    : MultiAssetOption(maturity), K_(strike), type_(type) {}
+
+double RainbowPutOption::payoff(const MultiPathView& paths) const {
+    return std::max(K_ - rainbowValue(paths, type_), 0.0);
+}
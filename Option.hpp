@@ -3,6 +3,8 @@
 #include <vector>
 #include <algorithm> // for min_element, max_element
 #include <stdexcept> // for exceptions
+#include <string>
+#include "PathView.hpp"
 
 
 // ============ Abstract class for Option ================
@@ -17,8 +19,41 @@ public:
 
     virtual ~Option() = default;
 
-    // path: vector of prices S_0, S_1, ..., S_n
-    virtual double payoff(const std::vector<double>& path) const = 0;
+    // path: view on prices S_0, S_1, ..., S_n (a std::vector converts implicitly)
+    virtual double payoff(PathView<double> path) const = 0;
+
+    // même payoff évalué en simple précision (mode Precision::Float de PricingMC)
+    virtual float payoff(PathView<float> path) const = 0;
+
+    // surveillance continue : si true, le pricer appelle bridgedPayoff avec la
+    // variance du log-prix sur chaque pas (stepVariance[i] pour le pas i -> i+1)
+    virtual bool needsStepVariance() const { return false; }
+
+    virtual double bridgedPayoff(PathView<double> path, PathView<double> /*stepVariance*/) const {
+        return payoff(path);
+    }
+    virtual float bridgedPayoff(PathView<float> path, PathView<float> /*stepVariance*/) const {
+        return payoff(path);
+    }
+
+    // pour PricingPDE : le payoff ne dépend que du dernier prix du path
+    // (vanilles, digitales) ; payoff sur un path d'un point donne alors la
+    // condition terminale
+    virtual bool terminalOnly() const { return false; }
+
+    // exercice à tout instant (américaines) : le payoff sur un path est le
+    // max de la valeur intrinsèque le long du path, donc pas terminalOnly() ;
+    // payoff sur un path d'un point est la valeur d'exercice en ce point
+    virtual bool earlyExercise() const { return false; }
+
+    // type et paramètres du contrat, réels en hexadécimal : deux contrats
+    // différents ont des descriptions différentes (empreinte des shards)
+    virtual std::string describe() const = 0;
+
+    // point singulier du payoff, autour duquel PricingPDE resserre sa grille
+    virtual double strike() const {
+        throw std::logic_error("Option has no strike");
+    }
 };
 
 
@@ -27,20 +62,18 @@ class CallVanillaOption : public Option {
 private:
     double K_;
 
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    CallVanillaOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {
-        if (K_ <= 0.0)
-            throw std::invalid_argument("Strike must be positive");
-    }
+    CallVanillaOption(double strike, double maturity);
 
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Price path is empty");
-        // European style payoff depends only on final price
-        double S_T = path.back();
-        return std::max(S_T - K_, 0.0);
-    }
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    bool terminalOnly() const override { return true; }
+    double strike() const override { return K_; }
 };
 
 
@@ -49,49 +82,48 @@ class PutVanillaOption : public Option {
 private:
     double K_;
 
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    PutVanillaOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {
-        if (K_ <= 0.0)
-            throw std::invalid_argument("Strike must be positive");
-    }
+    PutVanillaOption(double strike, double maturity);
 
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Price path is empty");
-        double S_T = path.back();
-        return std::max(K_ - S_T, 0.0);
-    }
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    bool terminalOnly() const override { return true; }
+    double strike() const override { return K_; }
 };
 
 
 // Lookback Call (floating strike: S_T - min_{t} S_t)
 class LookBackCallOption : public Option {
+private:
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    LookBackCallOption(double maturity) : Option(maturity) {}
+    LookBackCallOption(double maturity);
 
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Price path is empty");
-        double S_T = path.back();
-        double minPrice = *std::min_element(path.begin(), path.end());
-        return std::max(S_T - minPrice, 0.0);
-    }
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
 };
 
 
 // Lookback Put (floating strike: max_{t} S_t - S_T)
 class LookBackPutOption : public Option {
+private:
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    LookBackPutOption(double maturity) : Option(maturity) {}
+    LookBackPutOption(double maturity);
 
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty())
-            throw std::invalid_argument("Price path is empty");
-        double S_T = path.back();
-        double maxPrice = *std::max_element(path.begin(), path.end());
-        return std::max(maxPrice - S_T, 0.0);
-    }
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
 };
 
 // ------ Digital Call --------
@@ -99,13 +131,19 @@ class DigitalCallOption : public Option {
 private:
     double K_;
     double payout_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    DigitalCallOption(double strike, double maturity, double payout=1.0)
-        : Option(maturity), K_(strike), payout_(payout) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        return (path.back() > K_) ? payout_ : 0.0;
-    }
+    DigitalCallOption(double strike, double maturity, double payout=1.0);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    bool terminalOnly() const override { return true; }
+    double strike() const override { return K_; }
 };
 
 // ------ Digital Put --------
@@ -113,13 +151,19 @@ class DigitalPutOption : public Option {
 private:
     double K_;
     double payout_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    DigitalPutOption(double strike, double maturity, double payout=1.0)
-        : Option(maturity), K_(strike), payout_(payout) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        return (path.back() < K_) ? payout_ : 0.0;
-    }
+    DigitalPutOption(double strike, double maturity, double payout=1.0);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    bool terminalOnly() const override { return true; }
+    double strike() const override { return K_; }
 };
 
 
@@ -130,21 +174,16 @@ class AsianCallOption : public Option {
 private:
     double K_;
     AsianType type_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    AsianCallOption(double strike, double maturity, AsianType type=AsianType::Arithmetic)
-        : Option(maturity), K_(strike), type_(type) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        double avg = 0.0;
-        if (type_ == AsianType::Arithmetic) {
-            avg = std::accumulate(path.begin(), path.end(), 0.0) / path.size();
-        } else {
-            double sumLog = 0.0;
-            for (double p : path) sumLog += std::log(p);
-            avg = std::exp(sumLog / path.size());
-        }
-        return std::max(avg - K_, 0.0);
-    }
+    AsianCallOption(double strike, double maturity, AsianType type=AsianType::Arithmetic);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
 };
 
 // ------ Asian Put --------
@@ -152,58 +191,187 @@ class AsianPutOption : public Option {
 private:
     double K_;
     AsianType type_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    AsianPutOption(double strike, double maturity, AsianType type=AsianType::Arithmetic)
-        : Option(maturity), K_(strike), type_(type) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        double avg = 0.0;
-        if (type_ == AsianType::Arithmetic) {
-            avg = std::accumulate(path.begin(), path.end(), 0.0) / path.size();
-        } else {
-            double sumLog = 0.0;
-            for (double p : path) sumLog += std::log(p);
-            avg = std::exp(sumLog / path.size());
-        }
-        return std::max(K_ - avg, 0.0);
-    }
+    AsianPutOption(double strike, double maturity, AsianType type=AsianType::Arithmetic);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
 };
 
 
 // ------ American Call Option -------
+// (approximates payoff by max intrinsic over path)
 class AmericanCallOption : public Option {
 private:
     double K_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
 public:
-    AmericanCallOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        double maxPayoff = 0.0;
-        for (double price : path) {
-            double intrinsic = std::max(price - K_, 0.0);
-            if (intrinsic > maxPayoff) maxPayoff = intrinsic;
-        }
-        return maxPayoff;
-    }
+    AmericanCallOption(double strike, double maturity);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    double strike() const override { return K_; }
+    bool earlyExercise() const override { return true; }
 };
 
 // ------ American Put Option -------
 class AmericanPutOption : public Option {
 private:
     double K_;
+
+    template <typename Real>
+    Real evaluate(PathView<Real> path) const;
+
+public:
+    AmericanPutOption(double strike, double maturity);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+
+    double strike() const override { return K_; }
+    bool earlyExercise() const override { return true; }
+};
+
+
+// ------ Barrier Options -------
+// Knock-out : payoff vanille si la barrière n'est jamais touchée ;
+// knock-in : payoff vanille si elle est touchée.
+// payoff(path) surveille la barrière aux dates du path uniquement ;
+// bridgedPayoff ajoute entre deux dates la probabilité de franchissement du
+// pont brownien, ce qui approche la surveillance continue avec peu de pas.
+enum class BarrierType { UpAndOut, UpAndIn, DownAndOut, DownAndIn };
+
+class BarrierOption : public Option {
+protected:
+    double K_;
+    double B_;
+    BarrierType type_;
+
+    BarrierOption(double strike, double barrier, double maturity, BarrierType type);
+
+    // probabilité de ne pas avoir touché la barrière (stepVariance vide :
+    // surveillance discrète)
+    template <typename Real>
+    Real survival(PathView<Real> path, PathView<Real> stepVariance) const;
+
+public:
+    double strike() const override { return K_; }
+    double barrier() const { return B_; }
+    BarrierType barrierType() const { return type_; }
+    bool isUp() const { return type_ == BarrierType::UpAndOut || type_ == BarrierType::UpAndIn; }
+    bool isKnockOut() const { return type_ == BarrierType::UpAndOut || type_ == BarrierType::DownAndOut; }
+
+    bool needsStepVariance() const override { return true; }
+};
+
+class BarrierCallOption : public BarrierOption {
+private:
+    template <typename Real>
+    Real evaluate(PathView<Real> path, PathView<Real> stepVariance) const;
+
+public:
+    BarrierCallOption(double strike, double barrier, double maturity, BarrierType type);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+    double bridgedPayoff(PathView<double> path, PathView<double> stepVariance) const override;
+    float bridgedPayoff(PathView<float> path, PathView<float> stepVariance) const override;
+};
+
+class BarrierPutOption : public BarrierOption {
+private:
+    template <typename Real>
+    Real evaluate(PathView<Real> path, PathView<Real> stepVariance) const;
+
 public:
-    AmericanPutOption(double strike, double maturity)
-        : Option(maturity), K_(strike) {}
-    double payoff(const std::vector<double>& path) const override {
-        if (path.empty()) throw std::invalid_argument("Path is empty");
-        double maxPayoff = 0.0;
-        for (double price : path) {
-            double intrinsic = std::max(K_ - price, 0.0);
-            if (intrinsic > maxPayoff) maxPayoff = intrinsic;
-        }
-        return maxPayoff;
+    BarrierPutOption(double strike, double barrier, double maturity, BarrierType type);
+
+    double payoff(PathView<double> path) const override;
+    float payoff(PathView<float> path) const override;
+    std::string describe() const override;
+    double bridgedPayoff(PathView<double> path, PathView<double> stepVariance) const override;
+    float bridgedPayoff(PathView<float> path, PathView<float> stepVariance) const override;
+};
+
+
+// ============ Abstract class for multi-asset Option ================
+class MultiAssetOption {
+public:
+    double T; // maturity in years
+
+    MultiAssetOption(double maturity = 0.0) : T(maturity) {
+        if (T <= 0.0)
+            throw std::invalid_argument("Maturity must be positive");
     }
+
+    virtual ~MultiAssetOption() = default;
+
+    // paths(a, t) : prix du sous-jacent a à la date t
+    virtual double payoff(const MultiPathView& paths) const = 0;
+};
+
+
+// ------ Basket Call / Put --------
+// panier sum_a w_a S_a(T) ; des poids (1, -1) donnent un spread
+class BasketCallOption : public MultiAssetOption {
+private:
+    std::vector<double> weights_;
+    double K_;
+
+public:
+    BasketCallOption(const std::vector<double>& weights, double strike, double maturity);
+
+    double payoff(const MultiPathView& paths) const override;
+};
+
+class BasketPutOption : public MultiAssetOption {
+private:
+    std::vector<double> weights_;
+    double K_;
+
+public:
+    BasketPutOption(const std::vector<double>& weights, double strike, double maturity);
+
+    double payoff(const MultiPathView& paths) const override;
+};
+
+
+// ------ Rainbow Call / Put --------
+// sur le meilleur (BestOf) ou le moins bon (WorstOf) des S_a(T)
+enum class RainbowType { BestOf, WorstOf };
+
+class RainbowCallOption : public MultiAssetOption {
+private:
+    double K_;
+    RainbowType type_;
+
+public:
+    RainbowCallOption(double strike, double maturity, RainbowType type=RainbowType::BestOf);
+
+    double payoff(const MultiPathView& paths) const override;
+};
+
+class RainbowPutOption : public MultiAssetOption {
+private:
+    double K_;
+    RainbowType type_;
+
+public:
+    RainbowPutOption(double strike, double maturity, RainbowType type=RainbowType::WorstOf);
+
+    double payoff(const MultiPathView& paths) const override;
 };
 
-#endif
\ No newline at end of file
+#endif
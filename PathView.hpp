@@ -0,0 +1,69 @@
+#ifndef _PATH_VIEW_
+#define _PATH_VIEW_
+
+#include <cstddef>
+#include <vector>
+
+// ============ Vue non-propriétaire sur un path ================
+// (pointeur, longueur, pas) : permet de lire un path directement dans un
+// buffer batché, time-major ou mappé en mémoire, sans copie.
+// Le buffer doit rester valide pendant toute l'utilisation de la vue.
+template <typename Real>
+class PathView {
+private:
+    const Real* data_;
+    std::size_t size_;
+    std::ptrdiff_t stride_;
+
+public:
+    PathView(const Real* data, std::size_t size, std::ptrdiff_t stride = 1)
+        : data_(data), size_(size), stride_(stride) {}
+
+    // conversion implicite depuis un vector contigu
+    PathView(const std::vector<Real>& path)
+        : data_(path.data()), size_(path.size()), stride_(1) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::ptrdiff_t stride() const { return stride_; }
+    const Real* data() const { return data_; }
+
+    const Real& operator[](std::size_t i) const {
+        return data_[static_cast<std::ptrdiff_t>(i) * stride_];
+    }
+    const Real& front() const { return data_[0]; }
+    const Real& back() const { return (*this)[size_ - 1]; }
+};
+
+
+// ============ Vue sur un path multi-sous-jacents ================
+// (a, t) -> data[a * assetStride + t * timeStride] ; asset(a) donne le
+// path du sous-jacent a comme un PathView ordinaire.
+class MultiPathView {
+private:
+    const double* data_;
+    int nAssets_;
+    int nTimes_;
+    std::ptrdiff_t assetStride_;
+    std::ptrdiff_t timeStride_;
+
+public:
+    MultiPathView(const double* data, int nAssets, int nTimes,
+                  std::ptrdiff_t assetStride, std::ptrdiff_t timeStride)
+        : data_(data), nAssets_(nAssets), nTimes_(nTimes),
+          assetStride_(assetStride), timeStride_(timeStride) {}
+
+    int nAssets() const { return nAssets_; }
+    int nTimes() const { return nTimes_; }
+
+    double operator()(int asset, int t) const {
+        return data_[asset * assetStride_ + t * timeStride_];
+    }
+    double terminal(int asset) const { return (*this)(asset, nTimes_ - 1); }
+
+    PathView<double> asset(int a) const {
+        return PathView<double>(data_ + a * assetStride_, static_cast<std::size_t>(nTimes_), timeStride_);
+    }
+};
+
+#endif
@@ -1,31 +1,303 @@
 #include "PricingMC.hpp"
-#include <numeric>      // for std::accumulate
+#include "Arena.hpp"
+#include "CompensatedSum.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <stdexcept>
 
-double PricingMC::price() const {
+namespace {
+
+// remet le générateur du modèle (Model ou MultiAssetModel) à son seed
+// d'origine en sortie de portée
+template <typename M>
+class SeedRestore {
+private:
+    const M& model_;
+    unsigned long seed_;
+
+public:
+    explicit SeedRestore(const M& model) : model_(model), seed_(model.seed()) {}
+    ~SeedRestore() { model_.reseed(seed_); }
+
+    SeedRestore(const SeedRestore&) = delete;
+    SeedRestore& operator=(const SeedRestore&) = delete;
+};
+
+// FNV-1a 64 bits
+class Fnv1a {
+private:
+    unsigned long long h_ = 0xcbf29ce484222325ULL;
+
+public:
+    void add(const void* data, std::size_t n) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < n; ++i) {
+            h_ ^= bytes[i];
+            h_ *= 0x100000001b3ULL;
+        }
+    }
+    void add(const char* text) { add(text, std::strlen(text)); }
+    void add(double x) { add(&x, sizeof x); }
+    unsigned long long value() const { return h_; }
+};
+
+} // namespace
+
+PricingMC::PricingMC(const Option& opt,
+                     const Model& mod,
+                     int paths,
+                     int steps,
+                     double spot,
+                     Precision prec)
+    : option_(opt), model_(mod), nPaths(paths), nSteps(steps), S0(spot), precision(prec),
+      blockSize(4096), deltaBump(0.0) {}
+
+int PricingMC::nBlocks() const {
+    return (nPaths + blockSize - 1) / blockSize;
+}
+
+// splitmix64 sur (seed, block) : seeds décorrélés même pour des seeds voisins
+unsigned long PricingMC::blockSeed(unsigned long seed, int block) {
+    unsigned long long z = static_cast<unsigned long long>(seed)
+                         + 0x9E3779B97F4A7C15ULL * (static_cast<unsigned long long>(block) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<unsigned long>(z ^ (z >> 31));
+}
+
+template <typename Real, typename Sink>
+void PricingMC::samplePayoffs(int count, double spot, Real* paths, Real* stepVariance, Sink&& sink) const {
+    // lots complets de Model::batchPaths paths ; seuls les count premiers servent
+    const int batch = Model::batchPaths;
+    for (int p0 = 0; p0 < count; p0 += batch) {
+        model_.generatePaths(paths, stepVariance, spot, option_.T, nSteps);
+
+        // payoff en Real lu en place (pas batch), accumulé en double par sink
+        const int rows = std::min(batch, count - p0);
+        for (int p = 0; p < rows; ++p) {
+            const PathView<Real> view(paths + p, nSteps + 1, batch);
+            if (stepVariance)
+                sink(static_cast<double>(option_.bridgedPayoff(view, PathView<Real>(stepVariance + p, nSteps, batch))));
+            else
+                sink(static_cast<double>(option_.payoff(view)));
+        }
+    }
+}
+
+template <typename Real>
+MCBlock PricingMC::simulateBlock(int block, unsigned long seed, Real* paths, Real* stepVariance) const {
+    const int count = std::min(blockSize, nPaths - block * blockSize);
+    const unsigned long s = blockSeed(seed, block);
+
+    MCBlock res;
+    res.count = count;
+
+    CompensatedSum sum, sumSq;
+    model_.reseed(s);
+    samplePayoffs(count, S0, paths, stepVariance, [&](double p) {
+        sum.add(p);
+        sumSq.add(p * p);
+    });
+    res.sum = sum.value();
+    res.sumSq = sumSq.value();
+
+    // delta : mêmes tirages (même seed de bloc) sur les deux spots bumpés
+    if (deltaBump > 0.0) {
+        CompensatedSum up, down;
+        model_.reseed(s);
+        samplePayoffs(count, S0 * (1.0 + deltaBump), paths, stepVariance, [&up](double p) { up.add(p); });
+        model_.reseed(s);
+        samplePayoffs(count, S0 * (1.0 - deltaBump), paths, stepVariance, [&down](double p) { down.add(p); });
+        res.sumUp = up.value();
+        res.sumDown = down.value();
+    }
+    return res;
+}
+
+template <typename Real, typename Sink>
+void PricingMC::simulateBlocks(int firstBlock, int lastBlock, unsigned long seed, Sink&& sink) const {
+    // buffers d'un lot de paths pris dans l'arena du thread : pas d'allocation en régime établi
+    const std::size_t size = static_cast<std::size_t>(Model::batchPaths) * (nSteps + 1);
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    Real* paths = arena.allocate<Real>(size);
+    Real* stepVariance = option_.needsStepVariance() ? arena.allocate<Real>(size - Model::batchPaths) : nullptr;
+
+    for (int b = firstBlock; b < lastBlock; ++b)
+        sink(simulateBlock(b, seed, paths, stepVariance));
+}
+
+void PricingMC::checkParameters() const {
     if (nPaths <= 0 || nSteps <= 0) {
         throw std::invalid_argument("Number of paths and steps must be positive");
     }
+    if (blockSize <= 0)
+        throw std::invalid_argument("Block size must be positive");
+    if (deltaBump < 0.0 || deltaBump >= 1.0)
+        throw std::invalid_argument("Delta bump must be in [0,1)");
+}
 
-    // Storage for all discounted payoffs
-    std::vector<double> discountedPayoffs;
-    discountedPayoffs.reserve(nPaths);
+unsigned long long PricingMC::fingerprint() const {
+    checkParameters();
+    SeedRestore<Model> restore(model_);
 
-    for (int i = 0; i < nPaths; ++i) {
-        std::vector<double> path;
-        model_.generatePath(path, S0, option_.T, nSteps);
+    // paramètres exacts de l'option et du modèle
+    Fnv1a hash;
+    hash.add(option_.describe().c_str());
+    hash.add(model_.describe().c_str());
 
-        // Compute payoff for this path
-        double payoff = option_.payoff(path);
+    // sonde en plus : un lot de paths d'un seed fixe, indépendant du seed du
+    // run (distingue ce que describe ne voit pas, p.ex. la vol locale de LSVModel)
+    const int batch = Model::batchPaths;
+    const std::size_t size = static_cast<std::size_t>(batch) * (nSteps + 1);
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    double* paths = arena.allocate<double>(size);
+    double* stepVariance = option_.needsStepVariance() ? arena.allocate<double>(size - batch) : nullptr;
 
-        // Discount the payoff to present value
-        double discounted = payoff * model_.discount(option_.T);
+    model_.reseed(0);
+    model_.generatePaths(paths, stepVariance, S0, option_.T, nSteps);
+    hash.add(paths + size - batch, batch * sizeof(double));
+    for (int p = 0; p < batch; ++p) {
+        const PathView<double> view(paths + p, nSteps + 1, batch);
+        hash.add(stepVariance ? option_.bridgedPayoff(view, PathView<double>(stepVariance + p, nSteps, batch))
+                              : option_.payoff(view));
+    }
+    return hash.value();
+}
 
-        discountedPayoffs.push_back(discounted);
+MCShard PricingMC::simulateShard(int shardIndex, int nShards) const {
+    checkParameters();
+    if (nShards <= 0 || shardIndex < 0 || shardIndex >= nShards)
+        throw std::invalid_argument("Shard index must be in [0, nShards)");
+
+    SeedRestore<Model> restore(model_);
+
+    MCShard shard;
+    shard.seed = model_.seed();
+    shard.nPaths = nPaths;
+    shard.nSteps = nSteps;
+    shard.blockSize = blockSize;
+    shard.precision = (precision == Precision::Float) ? 1 : 0;
+    shard.S0 = S0;
+    shard.discount = model_.discount(option_.T);
+    shard.deltaBump = deltaBump;
+    shard.fingerprint = fingerprint();
+
+    // répartition équilibrée des blocs entre les shards
+    const long long total = nBlocks();
+    const int first = static_cast<int>(total * shardIndex / nShards);
+    const int last = static_cast<int>(total * (shardIndex + 1) / nShards);
+    shard.firstBlock = first;
+    shard.blocks.reserve(last - first);
+
+    auto store = [&shard](const MCBlock& b) { shard.blocks.push_back(b); };
+    if (precision == Precision::Float)
+        simulateBlocks<float>(first, last, shard.seed, store);
+    else
+        simulateBlocks<double>(first, last, shard.seed, store);
+    return shard;
+}
+
+// même réduction bloc par bloc que reduceShards, sans stocker les blocs
+MCResult PricingMC::run() const {
+    checkParameters();
+    SeedRestore<Model> restore(model_);
+
+    const unsigned long seed = model_.seed();
+    MCAccumulator acc;
+    auto accumulate = [&acc](const MCBlock& b) { acc.add(b); };
+    if (precision == Precision::Float)
+        simulateBlocks<float>(0, nBlocks(), seed, accumulate);
+    else
+        simulateBlocks<double>(0, nBlocks(), seed, accumulate);
+    return acc.result(model_.discount(option_.T), deltaBump, S0);
+}
+
+double PricingMC::price() const {
+    return run().price;
+}
+
+PrecisionBias PricingMC::precisionBias() const {
+    PricingMC mc(*this);
+
+    PrecisionBias res;
+    mc.precision = Precision::Double;
+    res.priceDouble = mc.price();
+    mc.precision = Precision::Float;
+    res.priceFloat = mc.price();
+
+    res.bias = res.priceFloat - res.priceDouble;
+    res.relativeBias = (res.priceDouble != 0.0) ? res.bias / std::fabs(res.priceDouble) : 0.0;
+    return res;
+}
+
+// -------------------- PricingMultiAssetMC --------------------
+
+PricingMultiAssetMC::PricingMultiAssetMC(const MultiAssetOption& opt,
+                                         const MultiAssetModel& mod,
+                                         const std::vector<double>& spots,
+                                         int paths,
+                                         int steps)
+    : option_(opt), model_(mod), nPaths(paths), nSteps(steps), S0(spots),
+      blockSize(4096), pathsPerBatch(256) {}
+
+// blocs seedés comme PricingMC (blockSeed), chaque bloc simulé par lots
+MCResult PricingMultiAssetMC::run() const {
+    if (nPaths <= 0 || nSteps <= 0) {
+        throw std::invalid_argument("Number of paths and steps must be positive");
     }
+    if (blockSize <= 0)
+        throw std::invalid_argument("Block size must be positive");
+    if (pathsPerBatch <= 0)
+        throw std::invalid_argument("Batch size must be positive");
+
+    const int d = model_.nAssets();
+    if (static_cast<int>(S0.size()) != d)
+        throw std::invalid_argument("One spot per asset is required");
+
+    SeedRestore<MultiAssetModel> restore(model_);
+    const unsigned long seed = model_.seed();
 
-    // Compute Monte Carlo estimate (average)
-    double sumPayoffs = std::accumulate(discountedPayoffs.begin(), discountedPayoffs.end(), 0.0);
+    const std::size_t nTimes = static_cast<std::size_t>(nSteps) + 1;
+    const std::size_t pathSize = nTimes * d;
+    const std::size_t budget = std::size_t(1) << 20;  // doubles par lot
+    const int batch = static_cast<int>(std::max<std::size_t>(1,
+                          std::min<std::size_t>(pathsPerBatch, budget / pathSize)));
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    double* paths = arena.allocate<double>(batch * pathSize);
+
+    MCAccumulator acc;
+    const int nBlocks = (nPaths + blockSize - 1) / blockSize;
+    for (int b = 0; b < nBlocks; ++b) {
+        const int count = std::min(blockSize, nPaths - b * blockSize);
+        model_.reseed(PricingMC::blockSeed(seed, b));
+
+        CompensatedSum sum, sumSq;
+        for (int p0 = 0; p0 < count; p0 += batch) {
+            const int rows = std::min(batch, count - p0);
+            model_.generatePaths(paths, rows, S0.data(), option_.T, nSteps);
+
+            for (int p = 0; p < rows; ++p) {
+                MultiPathView view(paths + p * pathSize, d, static_cast<int>(nTimes), 1, d);
+                double payoff = option_.payoff(view);
+                sum.add(payoff);
+                sumSq.add(payoff * payoff);
+            }
+        }
+
+        MCBlock block;
+        block.sum = sum.value();
+        block.sumSq = sumSq.value();
+        block.count = count;
+        acc.add(block);
+    }
+    return acc.result(model_.discount(option_.T), 0.0, 0.0);
+}
 
-    return sumPayoffs / nPaths;
+double PricingMultiAssetMC::price() const {
+    return run().price;
 }
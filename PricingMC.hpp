@@ -3,25 +3,109 @@
 
 #include "Option.hpp"
 #include "Model.hpp"
+#include "Shard.hpp"
+
+// précision des paths et des payoffs ; les sommes restent en double
+enum class Precision { Double, Float };
+
+// écart de prix entre le mode Float et le mode Double (mêmes tirages)
+struct PrecisionBias {
+    double priceDouble;
+    double priceFloat;
+    double bias;          // priceFloat - priceDouble
+    double relativeBias;  // bias / |priceDouble| (0 si priceDouble == 0)
+};
 
 class PricingMC {
 private:
     const Option& option_;
     const Model& model_;
 
+    // simule count paths depuis spot par lots (Model::generatePaths) et appelle
+    // sink(payoff) pour chacun, dans l'ordre ; stepVariance n'est utilisé (et
+    // alloué) que pour les options à surveillance continue
+    template <typename Real, typename Sink>
+    void samplePayoffs(int count, double spot, Real* paths, Real* stepVariance, Sink&& sink) const;
+
+    template <typename Real>
+    MCBlock simulateBlock(int block, unsigned long seed, Real* paths, Real* stepVariance) const;
+
+    // appelle sink(bloc) pour chaque bloc de [firstBlock, lastBlock), dans l'ordre
+    template <typename Real, typename Sink>
+    void simulateBlocks(int firstBlock, int lastBlock, unsigned long seed, Sink&& sink) const;
+
+    void checkParameters() const;
+
 public:
     int nPaths;
     int nSteps;
     double S0;
+    Precision precision;
+    int blockSize;     // paths par bloc : unité de seeding et de découpage en shards
+                       // (de préférence multiple de Model::batchPaths)
+    double deltaBump;  // si > 0 : delta par différences centrées en S0*(1 +/- deltaBump)
 
     PricingMC(const Option& opt,
               const Model& mod,
               int paths = 10000,
               int steps = 252,
-              double spot = 100.0);
+              double spot = 100.0,
+              Precision prec = Precision::Double);
 
-    // prix Monte-Carlo standard (estimation simple, non vectorisée)
+    // prix Monte-Carlo (run().price)
     double price() const;
+
+    // prix, erreur standard et delta éventuel ; identique à reduceShards des shards
+    MCResult run() const;
+
+    int nBlocks() const;
+
+    // seed du bloc block, dérivé du seed du modèle
+    static unsigned long blockSeed(unsigned long seed, int block);
+
+    // empreinte de l'option et du modèle : Option::describe et Model::describe
+    // (types et paramètres exacts), plus les paths / payoffs d'un lot simulé
+    // avec un seed fixe ; reduceShards refuse des shards d'empreintes
+    // différentes. Le générateur du modèle est remis à son seed à la fin.
+    unsigned long long fingerprint() const;
+
+    // simule le shard shardIndex sur nShards (plage contiguë de blocs) ;
+    // le générateur du modèle est remis à son seed à la fin
+    MCShard simulateShard(int shardIndex, int nShards) const;
+
+    // harness de validation : price en Double puis en Float à partir du même
+    // seed et renvoie le biais
+    PrecisionBias precisionBias() const;
+};
+
+
+// Monte-Carlo multi-sous-jacents : les paths sont simulés par lots
+// (MultiAssetModel::generatePaths) puis évalués en place. Comme PricingMC,
+// le bloc b de blockSize paths part du seed PricingMC::blockSeed(seed, b) et
+// le générateur du modèle est remis à son seed à la fin : deux run() donnent
+// le même résultat.
+class PricingMultiAssetMC {
+private:
+    const MultiAssetOption& option_;
+    const MultiAssetModel& model_;
+
+public:
+    int nPaths;
+    int nSteps;
+    std::vector<double> S0;  // un spot par sous-jacent
+    int blockSize;           // paths par bloc : unité de seeding
+    int pathsPerBatch;       // borne haute, réduite pour garder le lot sous ~8 Mo
+
+    PricingMultiAssetMC(const MultiAssetOption& opt,
+                        const MultiAssetModel& mod,
+                        const std::vector<double>& spots,
+                        int paths = 10000,
+                        int steps = 252);
+
+    double price() const;
+
+    // prix et erreur standard
+    MCResult run() const;
 };
 
-#endif 
\ No newline at end of file
+#endif
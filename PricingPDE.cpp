@@ -0,0 +1,513 @@
+#include "PricingPDE.hpp"
+#include "Arena.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// étendue de la grille : [min(S0, K), max(S0, K)] élargi de stdDevs écarts-types
+// en log ; V_SS = 0 sur les bords libres
+const double stdDevs = 4.0;
+
+// densité de la grille en x = log S autour d'un centre c :
+// 1 + concentration / sqrt(1 + ((x - log c) / (width * sigma sqrt(T)))^2)
+const double concentration = 5.0;
+const double width = 2.0;
+
+// dates tau_k = T (x + grading (x^2 - x)), x = k / nTime : pas plus fins près
+// de l'échéance, où le gamma est le plus grand ; avec exercice anticipé la
+// frontière d'exercice varie en sqrt(tau), d'où un maillage en x^2
+const double timeGrading = 0.5;
+const double earlyExerciseGrading = 1.0;
+
+// sous-cellules pour la moyenne du payoff terminal sur les cellules où il
+// n'est pas affine (strikes et sauts de digitales entre deux noeuds) ; ces
+// cellules sont rares, et l'erreur sur la position d'un saut est en h / subCells
+const int subCells = 256;
+
+// grilles par défaut (nSpace = 0, nTime = 0). L'étendue de la grille croît
+// comme sigma sqrt(T) ; à nombre de noeuds fixe l'erreur aussi (call ATM à
+// 500 noeuds : 2e-5 à sigma sqrt(T) = 0.25, 2.6e-4 à 0.7). On garde donc un
+// nombre fixe de noeuds par tranche de referenceStdDev (au moins ce nombre),
+// plus élevé avec exercice anticipé (frontière d'exercice à résoudre), et
+// des pas de temps proportionnels à T pour les européennes.
+const double referenceStdDev = 0.25;
+const int spacePointsPerStdDev = 500;
+const int earlyExerciseSpacePointsPerStdDev = 750;
+const int timeStepsPerYear = 50;               // au moins timeStepsPerYear
+const int earlyExerciseTimeSteps = 200;
+const int earlyExerciseBlockSteps = 8;          // pas de même taille par bloc
+
+// Système tridiagonal (sub, diag, sup) résolu par élimination depuis les deux
+// bords vers le noeud central p = n / 2 (factorisation "twisted") : les deux
+// demi-balayages sont des chaînes de dépendance indépendantes, ce qui divise
+// par deux la latence par rapport à Thomas. La factorisation
+//   inv = 1 / pivot, m = (sub | sup) * inv, c = (sup | sub) * inv
+// (côté bas | côté haut) se réutilise tant que la matrice ne change pas.
+void tridiagFactor(const double* sub, const double* diag, const double* sup,
+                   double* inv, double* m, double* c, int n)
+{
+    const int p = n / 2;
+    inv[0] = 1.0 / diag[0];
+    m[0] = 0.0;
+    c[0] = sup[0] * inv[0];
+    inv[n - 1] = 1.0 / diag[n - 1];
+    m[n - 1] = 0.0;
+    c[n - 1] = sub[n - 1] * inv[n - 1];
+    for (int i = 1, j = n - 2; i < p; ++i, --j) {
+        inv[i] = 1.0 / (diag[i] - sub[i] * c[i - 1]);
+        m[i] = sub[i] * inv[i];
+        c[i] = sup[i] * inv[i];
+        if (j > p) {
+            inv[j] = 1.0 / (diag[j] - sup[j] * c[j + 1]);
+            m[j] = sup[j] * inv[j];
+            c[j] = sub[j] * inv[j];
+        }
+    }
+    inv[p] = 1.0 / (diag[p] - sub[p] * c[p - 1] - sup[p] * c[p + 1]);
+}
+
+// résout le système factorisé (x peut être rhs)
+void tridiagSolve(const double* sub, const double* sup,
+                  const double* inv, const double* m, const double* c,
+                  const double* rhs, double* x, int n)
+{
+    const int p = n / 2;
+    x[0] = rhs[0] * inv[0];
+    x[n - 1] = rhs[n - 1] * inv[n - 1];
+    for (int i = 1, j = n - 2; i < p; ++i, --j) {
+        x[i] = rhs[i] * inv[i] - m[i] * x[i - 1];
+        if (j > p)
+            x[j] = rhs[j] * inv[j] - m[j] * x[j + 1];
+    }
+    x[p] = (rhs[p] - sub[p] * x[p - 1] - sup[p] * x[p + 1]) * inv[p];
+    for (int i = p - 1, j = p + 1; i >= 0; --i, ++j) {
+        x[i] -= c[i] * x[i + 1];
+        if (j < n)
+            x[j] -= c[j] * x[j - 1];
+    }
+}
+
+// Exercice anticipé (Brennan-Schwartz) : élimination de Thomas dans un seul
+// sens, depuis le bord opposé à la zone d'exercice, puis remontée projetée
+// x = max(x, exercise) qui part du côté de la zone d'exercice. Un seul
+// balayage donne la solution du problème complémentaire discret quand la
+// zone d'exercice touche ce bord et est d'un seul tenant (put : bas de la
+// grille, call : haut) et que la matrice est une M-matrice.
+// inv = 1 / pivot, m = coefficient vers le noeud déjà éliminé * inv,
+// c = coefficient vers le noeud suivant de la remontée * inv.
+void projectedFactor(const double* sub, const double* diag, const double* sup,
+                     double* inv, double* m, double* c, int n, bool exerciseBelow)
+{
+    const double* eliminated = exerciseBelow ? sup : sub;
+    const double* remaining = exerciseBelow ? sub : sup;
+    const int first = exerciseBelow ? n - 1 : 0;
+    const int dir = exerciseBelow ? -1 : 1;
+    inv[first] = 1.0 / diag[first];
+    m[first] = 0.0;
+    c[first] = remaining[first] * inv[first];
+    for (int k = 1; k < n; ++k) {
+        const int i = first + dir * k;
+        inv[i] = 1.0 / (diag[i] - eliminated[i] * c[i - dir]);
+        m[i] = eliminated[i] * inv[i];
+        c[i] = remaining[i] * inv[i];
+    }
+}
+
+void projectedSolve(const double* inv, const double* m, const double* c, const double* rhs,
+                    const double* exercise, double* x, int n, bool exerciseBelow)
+{
+    const int first = exerciseBelow ? n - 1 : 0;
+    const int dir = exerciseBelow ? -1 : 1;
+    x[first] = rhs[first] * inv[first];
+    for (int k = 1; k < n; ++k) {
+        const int i = first + dir * k;
+        x[i] = rhs[i] * inv[i] - m[i] * x[i - dir];
+    }
+    const int last = first + dir * (n - 1);
+    x[last] = std::max(x[last], exercise[last]);
+    for (int k = n - 2; k >= 0; --k) {
+        const int i = first + dir * k;
+        x[i] = std::max(x[i] - c[i] * x[i + dir], exercise[i]);
+    }
+}
+
+} // namespace
+
+PricingPDE::PricingPDE(const Option& opt,
+                       const BSModel& mod,
+                       double spot,
+                       int spacePoints,
+                       int timeSteps)
+    : option_(opt), r_(mod.r()), sigma_(mod.sigma()),
+      nSpace(spacePoints), nTime(timeSteps), rannacherSteps(2), S0(spot) {}
+
+PricingPDE::PricingPDE(const Option& opt,
+                       const LSVModel& mod,
+                       double spot,
+                       int spacePoints,
+                       int timeSteps)
+    : option_(opt), r_(mod.r()), sigma_(std::sqrt(mod.theta())),
+      nSpace(spacePoints), nTime(timeSteps), rannacherSteps(2), S0(spot)
+{
+    if (mod.xi() != 0.0)
+        throw std::invalid_argument("PricingPDE needs a pure local vol LSVModel (xi = 0)");
+
+    // xi = 0 : la variance reste à theta, vol effective sigma_loc(S, t) sqrt(theta)
+    const std::function<double(double,double)> sigmaLocal = mod.sigmaLocal();
+    const double scale = sigma_;
+    localVol_ = [sigmaLocal, scale](double S, double t) { return sigmaLocal(S, t) * scale; };
+}
+
+PricingPDE::PricingPDE(const Option& opt,
+                       double r,
+                       std::function<double(double,double)> localVol,
+                       double spot,
+                       int spacePoints,
+                       int timeSteps)
+    : option_(opt), r_(r), sigma_(0.0), localVol_(std::move(localVol)),
+      nSpace(spacePoints), nTime(timeSteps), rannacherSteps(2), S0(spot)
+{
+    if (!localVol_)
+        throw std::invalid_argument("Local volatility function is empty");
+}
+
+void PricingPDE::checkParameters() const {
+    if (nSpace != 0 && nSpace < 5)
+        throw std::invalid_argument("nSpace must be 0 (automatic) or at least 5");
+    if (nTime < 0)
+        throw std::invalid_argument("nTime must be 0 (automatic) or positive");
+    if (rannacherSteps < 0 || (nTime > 0 && rannacherSteps > nTime))
+        throw std::invalid_argument("rannacherSteps must be in [0, nTime]");
+    if (S0 <= 0.0)
+        throw std::invalid_argument("Initial price S0 must be positive");
+}
+
+// noeuds équirépartis pour la densité en log S
+// 1 + sum_c concentration / sqrt(1 + ((x - log c) / a)^2), obtenus en inversant
+// sa primitive (tabulée par trapèzes)
+void PricingPDE::buildGrid(double* S, int n, double lower, double upper,
+                           const double* centers, int nCenters) const
+{
+    const double scale = width * std::max(volatility(S0, 0.0), 0.05) * std::sqrt(option_.T);
+
+    double logCenters[4];
+    for (int c = 0; c < nCenters; ++c)
+        logCenters[c] = std::log(centers[c]);
+
+    auto density = [&](double x) {
+        double g = 1.0;
+        for (int c = 0; c < nCenters; ++c) {
+            const double z = (x - logCenters[c]) / scale;
+            g += concentration / std::sqrt(1.0 + z * z);
+        }
+        return g;
+    };
+
+    ScratchArena::Scope scope(ScratchArena::local());
+    const int m = 4 * n;
+    const double lo = std::log(lower);
+    const double h = (std::log(upper) - lo) / m;
+    double* G = ScratchArena::local().allocate<double>(m + 1);
+
+    G[0] = 0.0;
+    double prev = density(lo);
+    for (int k = 1; k <= m; ++k) {
+        const double next = density(lo + k * h);
+        G[k] = G[k - 1] + 0.5 * h * (prev + next);
+        prev = next;
+    }
+
+    S[0] = lower;
+    int k = 0;
+    for (int i = 1; i < n - 1; ++i) {
+        const double target = G[m] * i / (n - 1);
+        while (G[k + 1] < target)
+            ++k;
+        S[i] = std::exp(lo + h * (k + (target - G[k]) / (G[k + 1] - G[k])));
+    }
+    S[n - 1] = upper;
+}
+
+template <typename Payoff>
+PDEResult PricingPDE::solve(const Payoff& payoff, double lower, double upper,
+                            bool absorbLower, bool absorbUpper, int n, int steps) const
+{
+    const double T = option_.T;
+    const bool american = option_.earlyExercise();
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+
+    double* S = arena.allocate<double>(n);
+    double* V = arena.allocate<double>(n);
+    double* next = arena.allocate<double>(n);
+    double* rhs = arena.allocate<double>(n);
+    // opérateur L (l, d, u) aux dates ancienne et nouvelle
+    double* lOld = arena.allocate<double>(n);
+    double* dOld = arena.allocate<double>(n);
+    double* uOld = arena.allocate<double>(n);
+    double* lNew = arena.allocate<double>(n);
+    double* dNew = arena.allocate<double>(n);
+    double* uNew = arena.allocate<double>(n);
+    // matrice I - theta dt L et sa factorisation
+    double* sub = arena.allocate<double>(n);
+    double* diag = arena.allocate<double>(n);
+    double* sup = arena.allocate<double>(n);
+    double* inv = arena.allocate<double>(n);
+    double* mul = arena.allocate<double>(n);
+    double* cfac = arena.allocate<double>(n);
+    double* exercise = american ? arena.allocate<double>(n) : nullptr;
+
+    double centers[4];
+    int nCenters = 0;
+    const double K = option_.strike();
+    if (K > lower && K < upper)
+        centers[nCenters++] = K;
+    if (absorbLower)
+        centers[nCenters++] = lower;
+    if (absorbUpper)
+        centers[nCenters++] = upper;
+    if (S0 > lower && S0 < upper && std::abs(S0 - K) > 1e-8 * K)
+        centers[nCenters++] = S0;
+    buildGrid(S, n, lower, upper, centers, nCenters);
+
+    // condition terminale : moyenne du payoff sur la cellule duale de chaque
+    // noeud (entre les milieux des intervalles voisins) là où il n'y est pas
+    // affine, valeur au noeud ailleurs
+    for (int i = 0; i < n; ++i) {
+        const double a = i > 0 ? 0.5 * (S[i - 1] + S[i]) : S[0];
+        const double b = i < n - 1 ? 0.5 * (S[i] + S[i + 1]) : S[n - 1];
+        const double center = payoff(S[i]);
+        const double left = payoff(a);
+        const double right = payoff(b);
+        const double affine = left + (right - left) * (S[i] - a) / (b - a);
+        if (std::abs(center - affine) <= 1e-12 * (std::abs(left) + std::abs(right))) {
+            V[i] = center;
+        } else {
+            const double h = (b - a) / subCells;
+            double sum = 0.0;
+            for (int k = 0; k < subCells; ++k)
+                sum += payoff(a + (k + 0.5) * h);
+            V[i] = sum / subCells;
+        }
+        if (american)
+            exercise[i] = center;
+    }
+    if (absorbLower) V[0] = 0.0;
+    if (absorbUpper) V[n - 1] = 0.0;
+
+    // Brennan-Schwartz suppose une seule frontière d'exercice : valeur
+    // d'exercice monotone, zone d'exercice du côté où elle est la plus grande
+    const bool exerciseBelow = american && exercise[0] > exercise[n - 1];
+    if (american) {
+        for (int i = 0; i + 1 < n; ++i) {
+            if (exerciseBelow ? exercise[i + 1] > exercise[i] : exercise[i + 1] < exercise[i])
+                throw std::invalid_argument("PricingPDE needs a monotone exercise value (one exercise boundary)");
+        }
+    }
+
+    // L V = 1/2 sigma^2 S^2 V_SS + r S V_S - r V, différences centrées non
+    // uniformes ; aux bords libres V_SS = 0 et dérive décentrée vers l'intérieur
+    auto buildOperator = [&](double t, double* l, double* d, double* u) {
+        for (int i = 0; i < n; ++i) {
+            const double drift = r_ * S[i];
+            if (i == 0) {
+                const double h = S[1] - S[0];
+                l[0] = 0.0;
+                u[0] = drift / h;
+                d[0] = -drift / h - r_;
+            } else if (i == n - 1) {
+                const double h = S[n - 1] - S[n - 2];
+                l[i] = -drift / h;
+                d[i] = drift / h - r_;
+                u[i] = 0.0;
+            } else {
+                const double hm = S[i] - S[i - 1];
+                const double hp = S[i + 1] - S[i];
+                const double sig = volatility(S[i], t);
+                const double diffusion = 0.5 * sig * sig * S[i] * S[i];
+                l[i] = (2.0 * diffusion - drift * hp) / (hm * (hm + hp));
+                u[i] = (2.0 * diffusion + drift * hm) / (hp * (hm + hp));
+                d[i] = -l[i] - u[i] - r_;
+            }
+        }
+    };
+
+    const bool constantVol = !localVol_;
+    buildOperator(T, lOld, dOld, uOld);
+    if (constantVol) {
+        std::copy(lOld, lOld + n, lNew);
+        std::copy(dOld, dOld + n, dNew);
+        std::copy(uOld, uOld + n, uNew);
+    }
+
+    // à vol constante la matrice ne dépend que de (theta, pas) : elle n'est
+    // refactorisée que lorsque l'un des deux change
+    double factoredTheta = -1.0;
+    double factoredStep = -1.0;
+
+    // un pas theta de tau vers tau + stepSize (t = T - tau)
+    auto step = [&](double tau, double stepSize, double theta) {
+        if (!constantVol)
+            buildOperator(T - tau - stepSize, lNew, dNew, uNew);
+
+        const double explicitPart = (1.0 - theta) * stepSize;
+        rhs[0] = V[0] + explicitPart * (dOld[0] * V[0] + uOld[0] * V[1]);
+        for (int i = 1; i < n - 1; ++i)
+            rhs[i] = V[i] + explicitPart * (lOld[i] * V[i - 1] + dOld[i] * V[i] + uOld[i] * V[i + 1]);
+        rhs[n - 1] = V[n - 1] + explicitPart * (lOld[n - 1] * V[n - 2] + dOld[n - 1] * V[n - 1]);
+        if (absorbLower) rhs[0] = 0.0;
+        if (absorbUpper) rhs[n - 1] = 0.0;
+
+        const bool refactor = !constantVol || theta != factoredTheta || stepSize != factoredStep;
+        if (refactor) {
+            const double implicitPart = theta * stepSize;
+            for (int i = 0; i < n; ++i) {
+                sub[i] = -implicitPart * lNew[i];
+                diag[i] = 1.0 - implicitPart * dNew[i];
+                sup[i] = -implicitPart * uNew[i];
+            }
+            if (absorbLower) { diag[0] = 1.0; sup[0] = 0.0; }
+            if (absorbUpper) { diag[n - 1] = 1.0; sub[n - 1] = 0.0; }
+            factoredTheta = theta;
+            factoredStep = stepSize;
+            if (american)
+                projectedFactor(sub, diag, sup, inv, mul, cfac, n, exerciseBelow);
+            else
+                tridiagFactor(sub, diag, sup, inv, mul, cfac, n);
+        }
+
+        if (american)
+            projectedSolve(inv, mul, cfac, rhs, exercise, next, n, exerciseBelow);
+        else
+            tridiagSolve(sub, sup, inv, mul, cfac, rhs, next, n);
+
+        std::swap(V, next);
+        if (!constantVol) {
+            std::swap(lOld, lNew);
+            std::swap(dOld, dNew);
+            std::swap(uOld, uNew);
+        }
+    };
+
+    // Rannacher : les premiers pas en deux demi-pas d'Euler implicite
+    // amortissent les oscillations dues aux singularités du payoff.
+    // Les dates graduées sont celles des fins de blocs ; le pas est constant
+    // dans un bloc, ce qui évite de refactoriser à chaque pas (un bloc par pas
+    // pour les européennes)
+    const double grading = american ? earlyExerciseGrading : timeGrading;
+    const int nBlocks = american ? (steps + earlyExerciseBlockSteps - 1) / earlyExerciseBlockSteps : steps;
+    double tau = 0.0;
+    int k = 0;
+    for (int b = 0; b < nBlocks; ++b) {
+        const int kEnd = static_cast<int>(static_cast<long long>(steps) * (b + 1) / nBlocks);
+        const double x = static_cast<double>(kEnd) / steps;
+        const double tauEnd = T * (x + grading * (x * x - x));
+        const double dt = (tauEnd - tau) / (kEnd - k);
+        for (int j = 0; k < kEnd; ++k, ++j) {
+            const double t = tau + j * dt;
+            if (k < rannacherSteps) {
+                step(t, 0.5 * dt, 1.0);
+                step(t + 0.5 * dt, 0.5 * dt, 1.0);
+            } else {
+                step(t, dt, 0.5);
+            }
+        }
+        tau = tauEnd;
+    }
+
+    // interpolation quadratique sur les trois noeuds les plus proches de S0
+    int j = static_cast<int>(std::upper_bound(S, S + n, S0) - S) - 1;
+    if (j + 1 < n && S[j + 1] - S0 < S0 - S[j])
+        ++j;
+    j = std::min(std::max(j - 1, 0), n - 3);
+
+    const double x0 = S[j], x1 = S[j + 1], x2 = S[j + 2];
+    const double y0 = V[j], y1 = V[j + 1], y2 = V[j + 2];
+    const double d0 = (x0 - x1) * (x0 - x2);
+    const double d1 = (x1 - x0) * (x1 - x2);
+    const double d2 = (x2 - x0) * (x2 - x1);
+    const double x = S0;
+
+    PDEResult res;
+    res.price = y0 * (x - x1) * (x - x2) / d0
+              + y1 * (x - x0) * (x - x2) / d1
+              + y2 * (x - x0) * (x - x1) / d2;
+    res.delta = y0 * (2.0 * x - x1 - x2) / d0
+              + y1 * (2.0 * x - x0 - x2) / d1
+              + y2 * (2.0 * x - x0 - x1) / d2;
+    res.gamma = 2.0 * (y0 / d0 + y1 / d1 + y2 / d2);
+    return res;
+}
+
+PDEResult PricingPDE::run() const {
+    checkParameters();
+
+    const BarrierOption* barrier = dynamic_cast<const BarrierOption*>(&option_);
+    if (!barrier && !option_.terminalOnly() && !option_.earlyExercise())
+        throw std::invalid_argument("PricingPDE only prices vanilla, digital, American and barrier options");
+
+    const double T = option_.T;
+    const double K = option_.strike();
+    const double sigma = std::max(volatility(S0, 0.0), 0.05);
+    const double spread = std::exp(stdDevs * sigma * std::sqrt(T));
+    const double lower = std::min(S0, K) / spread;
+    const double upper = std::max(S0, K) * spread;
+
+    const bool american = option_.earlyExercise();
+    const int perStdDev = american ? earlyExerciseSpacePointsPerStdDev : spacePointsPerStdDev;
+    const int n = nSpace > 0 ? nSpace
+                : std::max(perStdDev, static_cast<int>(std::ceil(perStdDev * sigma * std::sqrt(T) / referenceStdDev)));
+    const int steps = nTime > 0 ? nTime
+                    : american ? earlyExerciseTimeSteps
+                    : std::max(timeStepsPerYear, static_cast<int>(std::ceil(timeStepsPerYear * T)));
+    if (rannacherSteps > steps)
+        throw std::invalid_argument("rannacherSteps must be in [0, nTime]");
+
+    double point[2];
+    if (!barrier) {
+        auto terminal = [&](double S) {
+            point[0] = S;
+            return option_.payoff(PathView<double>(point, 1));
+        };
+        return solve(terminal, lower, upper, false, false, n, steps);
+    }
+
+    // knock-out : EDP sur la zone vivante, nulle sur la barrière.
+    // knock-in : vanille - knock-out ; le payoff vanille est celui d'un path
+    // qui part de la barrière (donc l'a touchée)
+    const double B = barrier->barrier();
+    const bool up = barrier->isUp();
+    const bool breached = up ? S0 >= B : S0 <= B;
+    const double bottom = up ? lower : B;
+    const double top = up ? B : upper;
+
+    if (barrier->isKnockOut()) {
+        if (breached)
+            return PDEResult{0.0, 0.0, 0.0};
+        auto terminal = [&](double S) {
+            point[0] = S;
+            return option_.payoff(PathView<double>(point, 1));
+        };
+        return solve(terminal, bottom, top, !up, up, n, steps);
+    }
+
+    auto terminal = [&](double S) {
+        point[0] = B;
+        point[1] = S;
+        return option_.payoff(PathView<double>(point, 2));
+    };
+    PDEResult vanilla = solve(terminal, lower, upper, false, false, n, steps);
+    if (breached)
+        return vanilla;
+    PDEResult knockOut = solve(terminal, bottom, top, !up, up, n, steps);
+    return PDEResult{vanilla.price - knockOut.price,
+                     vanilla.delta - knockOut.delta,
+                     vanilla.gamma - knockOut.gamma};
+}
+
+double PricingPDE::price() const {
+    return run().price;
+}
@@ -0,0 +1,84 @@
+#ifndef _PRICING_PDE_
+#define _PRICING_PDE_
+
+#include <functional>
+#include "Option.hpp"
+#include "Model.hpp"
+
+// ============ Pricer par différences finies (Crank-Nicolson) ================
+// Résout l'EDP de Black-Scholes en S, avec une volatilité constante
+// (BSModel) ou locale sigma(S, t) :
+//   V_t + 1/2 sigma^2 S^2 V_SS + r S V_S - r V = 0.
+// Grille non uniforme (en log S) resserrée autour du strike, du spot et de
+// la barrière, pas de temps resserrés près de l'échéance, premiers pas
+// remplacés par des pas d'Euler implicite (Rannacher), une résolution
+// tridiagonale en O(n) par pas, projetée sur la valeur d'exercice pour
+// l'exercice anticipé (Brennan-Schwartz, une seule frontière d'exercice).
+// Options acceptées : terminalOnly() (vanilles, digitales), earlyExercise()
+// (américaines) et barrières à surveillance continue (knock-in par parité
+// in/out).
+
+struct PDEResult {
+    double price;
+    double delta;
+    double gamma;
+};
+
+class PricingPDE {
+private:
+    const Option& option_;
+    double r_;
+    double sigma_;                                   // volatilité constante
+    std::function<double(double,double)> localVol_;  // sigma(S, t) ; vide : sigma_
+
+    double volatility(double S, double t) const {
+        return localVol_ ? localVol_(S, t) : sigma_;
+    }
+
+    // noeuds de [lower, upper], resserrés autour de centers
+    void buildGrid(double* S, int n, double lower, double upper,
+                   const double* centers, int nCenters) const;
+
+    // valeur en S0 de l'option de condition terminale payoff(S) sur
+    // [lower, upper] avec n noeuds et steps pas ; un bord absorbant vaut 0
+    // (barrière knock-out)
+    template <typename Payoff>
+    PDEResult solve(const Payoff& payoff, double lower, double upper,
+                    bool absorbLower, bool absorbUpper, int n, int steps) const;
+
+    void checkParameters() const;
+
+public:
+    int nSpace;          // noeuds d'espace ; 0 : 500 (750 si exercice anticipé)
+                         // par tranche de 0.25 de sigma sqrt(T), au moins 500 (750)
+    int nTime;           // pas de temps ; 0 : 50 par an (au moins 50), 200 si exercice anticipé
+    int rannacherSteps;  // pas de Crank-Nicolson remplacés par 2 demi-pas implicites
+    double S0;
+
+    PricingPDE(const Option& opt,
+               const BSModel& mod,
+               double spot = 100.0,
+               int spacePoints = 0,
+               int timeSteps = 0);
+
+    // vol locale pure : xi doit être nul (la variance reste alors à theta)
+    PricingPDE(const Option& opt,
+               const LSVModel& mod,
+               double spot = 100.0,
+               int spacePoints = 0,
+               int timeSteps = 0);
+
+    PricingPDE(const Option& opt,
+               double r,
+               std::function<double(double,double)> localVol,
+               double spot = 100.0,
+               int spacePoints = 0,
+               int timeSteps = 0);
+
+    double price() const;
+
+    // prix, delta et gamma lus sur la grille en S0
+    PDEResult run() const;
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "Shard.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+static const char* shardHeader = "pricingmc-shard 2";
+
+// -------------------- écriture / lecture --------------------
+
+void writeShard(const MCShard& shard, const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out)
+        throw std::runtime_error("Cannot open shard file for writing: " + filename);
+
+    out << shardHeader << "\n"
+        << "seed " << shard.seed << "\n"
+        << "nPaths " << shard.nPaths << "\n"
+        << "nSteps " << shard.nSteps << "\n"
+        << "blockSize " << shard.blockSize << "\n"
+        << "precision " << shard.precision << "\n"
+        << std::hexfloat
+        << "S0 " << shard.S0 << "\n"
+        << "discount " << shard.discount << "\n"
+        << "deltaBump " << shard.deltaBump << "\n"
+        << std::defaultfloat
+        << "fingerprint " << std::hex << shard.fingerprint << std::dec << "\n"
+        << "firstBlock " << shard.firstBlock << "\n"
+        << "blocks " << shard.blocks.size() << "\n";
+
+    for (const MCBlock& b : shard.blocks) {
+        out << std::hexfloat << b.sum << " " << b.sumSq << " "
+            << std::defaultfloat << b.count << " "
+            << std::hexfloat << b.sumUp << " " << b.sumDown << "\n";
+    }
+
+    if (!out)
+        throw std::runtime_error("Error while writing shard file: " + filename);
+}
+
+// les hexfloats sont relus avec strtod (operator>> ne les accepte pas partout)
+static double readReal(std::istream& in) {
+    std::string token;
+    if (!(in >> token))
+        throw std::runtime_error("Truncated shard file");
+    char* end = nullptr;
+    double x = std::strtod(token.c_str(), &end);
+    if (end == token.c_str() || *end != '\0')
+        throw std::runtime_error("Invalid number in shard file: " + token);
+    return x;
+}
+
+template <typename T>
+static T readField(std::istream& in, const std::string& key) {
+    std::string name;
+    T value;
+    if (!(in >> name >> value) || name != key)
+        throw std::runtime_error("Malformed shard file: expected '" + key + "'");
+    return value;
+}
+
+static double readRealField(std::istream& in, const std::string& key) {
+    std::string name;
+    if (!(in >> name) || name != key)
+        throw std::runtime_error("Malformed shard file: expected '" + key + "'");
+    return readReal(in);
+}
+
+MCShard readShard(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in)
+        throw std::runtime_error("Cannot open shard file: " + filename);
+
+    std::string header;
+    std::getline(in, header);
+    if (header != shardHeader)
+        throw std::runtime_error("Not a shard file: " + filename);
+
+    MCShard shard;
+    shard.seed = readField<unsigned long>(in, "seed");
+    shard.nPaths = readField<int>(in, "nPaths");
+    shard.nSteps = readField<int>(in, "nSteps");
+    shard.blockSize = readField<int>(in, "blockSize");
+    shard.precision = readField<int>(in, "precision");
+    shard.S0 = readRealField(in, "S0");
+    shard.discount = readRealField(in, "discount");
+    shard.deltaBump = readRealField(in, "deltaBump");
+    in >> std::hex;
+    shard.fingerprint = readField<unsigned long long>(in, "fingerprint");
+    in >> std::dec;
+    shard.firstBlock = readField<int>(in, "firstBlock");
+    std::size_t nBlocks = readField<std::size_t>(in, "blocks");
+
+    shard.blocks.resize(nBlocks);
+    for (MCBlock& b : shard.blocks) {
+        b.sum = readReal(in);
+        b.sumSq = readReal(in);
+        if (!(in >> b.count))
+            throw std::runtime_error("Truncated shard file: " + filename);
+        b.sumUp = readReal(in);
+        b.sumDown = readReal(in);
+    }
+    return shard;
+}
+
+// -------------------- réduction --------------------
+
+void MCAccumulator::add(const MCBlock& block) {
+    sum_.add(block.sum);
+    sumSq_.add(block.sumSq);
+    sumUp_.add(block.sumUp);
+    sumDown_.add(block.sumDown);
+    count_ += block.count;
+}
+
+MCResult MCAccumulator::result(double discount, double deltaBump, double S0) const {
+    MCResult res;
+    res.count = count_;
+    if (count_ == 0)
+        return res;
+
+    const double n = static_cast<double>(count_);
+    const double mean = sum_.value() / n;
+    res.price = discount * mean;
+    if (count_ > 1) {
+        double var = std::max((sumSq_.value() - n * mean * mean) / (n - 1.0), 0.0);
+        res.stdError = discount * std::sqrt(var / n);
+    }
+    if (deltaBump > 0.0) {
+        res.hasDelta = true;
+        res.delta = discount * (sumUp_.value() - sumDown_.value()) / (n * 2.0 * deltaBump * S0);
+    }
+    return res;
+}
+
+static bool sameConfig(const MCShard& a, const MCShard& b) {
+    return a.seed == b.seed && a.nPaths == b.nPaths && a.nSteps == b.nSteps
+        && a.blockSize == b.blockSize && a.precision == b.precision
+        && a.S0 == b.S0 && a.discount == b.discount && a.deltaBump == b.deltaBump
+        && a.fingerprint == b.fingerprint;
+}
+
+MCResult reduceShards(std::vector<MCShard> shards) {
+    if (shards.empty())
+        throw std::invalid_argument("No shard to reduce");
+
+    const MCShard& ref = shards.front();
+    for (const MCShard& s : shards) {
+        if (!sameConfig(s, ref))
+            throw std::invalid_argument("Shards come from different pricing configurations");
+    }
+
+    std::sort(shards.begin(), shards.end(),
+              [](const MCShard& a, const MCShard& b) { return a.firstBlock < b.firstBlock; });
+
+    // les shards doivent couvrir les blocs 0..nBlocks-1 sans trou ni recouvrement
+    const int nBlocks = (ref.nPaths + ref.blockSize - 1) / ref.blockSize;
+    int next = 0;
+    for (const MCShard& s : shards) {
+        if (s.firstBlock != next)
+            throw std::invalid_argument("Shards do not cover the path range exactly");
+        next += static_cast<int>(s.blocks.size());
+    }
+    if (next != nBlocks)
+        throw std::invalid_argument("Shards do not cover the path range exactly");
+
+    MCAccumulator acc;
+    for (const MCShard& s : shards) {
+        for (const MCBlock& b : s.blocks)
+            acc.add(b);
+    }
+    return acc.result(ref.discount, ref.deltaBump, ref.S0);
+}
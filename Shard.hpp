@@ -0,0 +1,69 @@
+#ifndef _SHARD_
+#define _SHARD_
+
+#include "CompensatedSum.hpp"
+#include <string>
+#include <vector>
+
+// ============ Résultats Monte-Carlo fusionnables ================
+// Les paths d'un PricingMC sont découpés en blocs de blockSize paths ;
+// le bloc b est simulé avec un seed dérivé de (seed du modèle, b). Un shard
+// est une plage contiguë de blocs : les shards calculés par des processus
+// séparés se fusionnent en un résultat identique au bit près à un run
+// mono-processus, car la réduction se fait toujours bloc par bloc, dans
+// l'ordre des blocs.
+
+// statistiques d'un bloc (payoffs non actualisés)
+struct MCBlock {
+    double sum = 0.0;
+    double sumSq = 0.0;
+    long long count = 0;
+    double sumUp = 0.0;    // delta : payoffs avec S0*(1+h), mêmes tirages
+    double sumDown = 0.0;  //         payoffs avec S0*(1-h)
+};
+
+struct MCShard {
+    // configuration du run (doit être identique dans tous les shards)
+    unsigned long seed = 0;
+    int nPaths = 0;
+    int nSteps = 0;
+    int blockSize = 0;
+    int precision = 0;       // 0 = Double, 1 = Float
+    double S0 = 0.0;
+    double discount = 1.0;
+    double deltaBump = 0.0;  // 0 : pas de delta
+    unsigned long long fingerprint = 0;  // option et modèle (PricingMC::fingerprint)
+
+    int firstBlock = 0;
+    std::vector<MCBlock> blocks;
+};
+
+struct MCResult {
+    double price = 0.0;
+    double stdError = 0.0;
+    long long count = 0;
+    bool hasDelta = false;
+    double delta = 0.0;
+};
+
+// accumulation des blocs, dans l'ordre des blocs
+class MCAccumulator {
+private:
+    CompensatedSum sum_, sumSq_, sumUp_, sumDown_;
+    long long count_ = 0;
+
+public:
+    void add(const MCBlock& block);
+
+    // discount, deltaBump et S0 du run
+    MCResult result(double discount, double deltaBump, double S0) const;
+};
+
+// fichiers texte ; les réels sont écrits en hexadécimal (round-trip exact)
+void writeShard(const MCShard& shard, const std::string& filename);
+MCShard readShard(const std::string& filename);
+
+// fusionne des shards (dans n'importe quel ordre) couvrant tous les blocs
+MCResult reduceShards(std::vector<MCShard> shards);
+
+#endif
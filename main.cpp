@@ -1,16 +1,277 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "HestonCalibration.hpp"
 #include "PricingMC.hpp"
+#include "PricingPDE.hpp"
 
-int main() {
-    // Paramètres
-    double S0 = 100.0;
-    double r = 0.02;
-    double sigma = 0.25;
-    double T = 1.0; // 1 an
-    int nSteps = 252;
-    int nPaths = 100000; // Ajuste selon ton CPU
-
-    // Modèle
-    // TODO ...
+// Paramètres
+static const double S0 = 100.0;
+static const double r = 0.02;
+static const double sigma = 0.25;
+static const double T = 1.0; // 1 an
+static const double K = 100.0;
+static const int nSteps = 252;
+static const int nPaths = 100000; // Ajuste selon ton CPU
+
+static void printResult(const MCResult& res) {
+    std::cout << std::setprecision(17)
+              << "price    " << res.price << "\n"
+              << "stdError " << res.stdError << "\n"
+              << "paths    " << res.count << "\n";
+    if (res.hasDelta)
+        std::cout << "delta    " << res.delta << "\n";
+}
+
+// Validation du mode Float : biais par rapport au mode Double, par type d'option
+static int precisionReport() {
+    BSModel model(r, sigma);
+
+    std::vector<std::pair<std::string, std::unique_ptr<Option>>> book;
+    book.emplace_back("Call", std::make_unique<CallVanillaOption>(K, T));
+    book.emplace_back("Put", std::make_unique<PutVanillaOption>(K, T));
+    book.emplace_back("LookBackCall", std::make_unique<LookBackCallOption>(T));
+    book.emplace_back("LookBackPut", std::make_unique<LookBackPutOption>(T));
+    book.emplace_back("DigitalCall", std::make_unique<DigitalCallOption>(K, T));
+    book.emplace_back("DigitalPut", std::make_unique<DigitalPutOption>(K, T));
+    book.emplace_back("AsianCall", std::make_unique<AsianCallOption>(K, T));
+    book.emplace_back("AsianPut", std::make_unique<AsianPutOption>(K, T));
+    book.emplace_back("AmericanCall", std::make_unique<AmericanCallOption>(K, T));
+    book.emplace_back("AmericanPut", std::make_unique<AmericanPutOption>(K, T));
+    book.emplace_back("DownOutCall", std::make_unique<BarrierCallOption>(K, 90.0, T, BarrierType::DownAndOut));
+    book.emplace_back("UpInPut", std::make_unique<BarrierPutOption>(K, 110.0, T, BarrierType::UpAndIn));
+
+    std::cout << std::left << std::setw(14) << "Option"
+              << std::right << std::setw(14) << "Double"
+              << std::setw(14) << "Float"
+              << std::setw(14) << "Bias"
+              << std::setw(14) << "RelBias" << "\n";
+
+    for (const auto& entry : book) {
+        PricingMC mc(*entry.second, model, nPaths, nSteps, S0);
+        PrecisionBias b = mc.precisionBias();
+
+        std::cout << std::left << std::setw(14) << entry.first << std::right
+                  << std::fixed << std::setprecision(6)
+                  << std::setw(14) << b.priceDouble
+                  << std::setw(14) << b.priceFloat
+                  << std::scientific << std::setprecision(2)
+                  << std::setw(14) << b.bias
+                  << std::setw(14) << b.relativeBias << "\n";
+    }
+    return 0;
+}
+
+// Pricing par EDP (Crank-Nicolson) des options à payoff terminal et des
+// barrières, avec le temps de calcul par option
+static int pdeReport() {
+    BSModel model(r, sigma);
+
+    std::vector<std::pair<std::string, std::unique_ptr<Option>>> book;
+    book.emplace_back("Call", std::make_unique<CallVanillaOption>(K, T));
+    book.emplace_back("Put", std::make_unique<PutVanillaOption>(K, T));
+    book.emplace_back("DigitalCall", std::make_unique<DigitalCallOption>(K, T));
+    book.emplace_back("DigitalPut", std::make_unique<DigitalPutOption>(K, T));
+    book.emplace_back("AmericanCall", std::make_unique<AmericanCallOption>(K, T));
+    book.emplace_back("AmericanPut", std::make_unique<AmericanPutOption>(K, T));
+    book.emplace_back("DownOutCall", std::make_unique<BarrierCallOption>(K, 90.0, T, BarrierType::DownAndOut));
+    book.emplace_back("UpInPut", std::make_unique<BarrierPutOption>(K, 110.0, T, BarrierType::UpAndIn));
+
+    std::cout << std::left << std::setw(14) << "Option"
+              << std::right << std::setw(14) << "Price"
+              << std::setw(14) << "Delta"
+              << std::setw(14) << "Gamma"
+              << std::setw(14) << "Time (us)" << "\n";
+
+    for (const auto& entry : book) {
+        PricingPDE pde(*entry.second, model, S0);
+        auto start = std::chrono::steady_clock::now();
+        PDEResult res = pde.run();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(14) << entry.first << std::right
+                  << std::fixed << std::setprecision(6)
+                  << std::setw(14) << res.price
+                  << std::setw(14) << res.delta
+                  << std::setw(14) << res.gamma
+                  << std::setprecision(0)
+                  << std::setw(14) << us << "\n";
+    }
+    return 0;
+}
+
+// Multi-sous-jacents : option d'échange max(S1 - S2, 0) contre la formule de
+// Margrabe, puis temps d'un basket call sur 100 sous-jacents corrélés
+static int multiReport() {
+    const double s1 = 100.0, s2 = 95.0, sigma1 = 0.2, sigma2 = 0.3, rho = 0.5;
+    MultiAssetBSModel pair(r, {sigma1, sigma2}, {1.0, rho, rho, 1.0});
+    BasketCallOption exchange({1.0, -1.0}, 0.0, T);
+    PricingMultiAssetMC mc(exchange, pair, {s1, s2}, 1000000, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    MCResult res = mc.run();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const bool repeatable = mc.run().price == res.price;
+
+    const double sig = std::sqrt(sigma1 * sigma1 + sigma2 * sigma2 - 2.0 * rho * sigma1 * sigma2);
+    const double d1 = (std::log(s1 / s2) + 0.5 * sig * sig * T) / (sig * std::sqrt(T));
+    const double d2 = d1 - sig * std::sqrt(T);
+    auto N = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    const double margrabe = s1 * N(d1) - s2 * N(d2);
+
+    std::cout << std::fixed << std::setprecision(6)
+              << "Exchange (Margrabe), " << res.count << " paths\n"
+              << "  MC          " << res.price << " +/- " << res.stdError << "\n"
+              << "  closed form " << margrabe << "\n"
+              << "  error       " << std::setprecision(2) << (res.price - margrabe) / res.stdError << " std errors\n"
+              << "  repeat run  " << (repeatable ? "identical" : "DIFFERENT") << "\n"
+              << "  time        " << std::setprecision(0) << ms << " ms\n";
+
+    const int d = 100;
+    std::vector<double> sigmas(d, sigma);
+    std::vector<double> correlation(d * d, 0.3);
+    for (int a = 0; a < d; ++a) correlation[a * d + a] = 1.0;
+    MultiAssetBSModel basketModel(r, sigmas, correlation);
+    BasketCallOption basket(std::vector<double>(d, 1.0 / d), K, T);
+    PricingMultiAssetMC mcBasket(basket, basketModel, std::vector<double>(d, S0), 10000, 52);
+
+    start = std::chrono::steady_clock::now();
+    res = mcBasket.run();
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::setprecision(6)
+              << "Basket call, " << d << " assets, " << res.count << " paths x 52 steps\n"
+              << "  MC          " << res.price << " +/- " << res.stdError << "\n"
+              << "  time        " << std::setprecision(0) << ms << " ms\n";
+    return 0;
+}
+
+static double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+static double bsCall(double spot, double strike, double rate, double maturity, double vol) {
+    const double sd = vol * std::sqrt(maturity);
+    const double d1 = (std::log(spot / strike) + rate * maturity) / sd + 0.5 * sd;
+    return spot * normalCdf(d1) - strike * std::exp(-rate * maturity) * normalCdf(d1 - sd);
+}
+
+// vol implicite par dichotomie (le call est croissant en vol)
+static double impliedVol(double price, double spot, double strike, double rate, double maturity) {
+    double lo = 1e-4, hi = 3.0;
+    for (int i = 0; i < 100; ++i) {
+        const double mid = 0.5 * (lo + hi);
+        (bsCall(spot, strike, rate, maturity, mid) > price ? hi : lo) = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+static void printCalibration(const std::string& name, const CalibrationResult& res, double ms) {
+    const HestonParams& p = res.params;
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed
+              << std::setprecision(4)
+              << std::setw(10) << p.kappa << std::setw(10) << p.theta
+              << std::setw(10) << p.xi << std::setw(10) << p.rho
+              << std::scientific << std::setprecision(2) << std::setw(12) << res.rmse
+              << std::setw(8) << res.iterations
+              << std::setw(8) << (res.converged ? "yes" : "no")
+              << std::fixed << std::setprecision(1) << std::setw(10) << ms << "\n";
+}
+
+// Calibration de Heston sur une nappe synthétique de 200 quotes (10 maturités
+// x 20 strikes) tirée de paramètres connus : départ à froid, puis warm start
+// depuis le modèle de la veille
+static int calibrationReport() {
+    const HestonParams truth{2.0, 0.05, 0.5, -0.7};
+    const double maturities[] = {0.1, 0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0, 4.0, 5.0};
+
+    std::vector<VolQuote> surface;
+    for (double mat : maturities) {
+        for (int j = 0; j < 20; ++j) {
+            const double strike = S0 * std::exp((-0.5 + j / 19.0) * 0.8 * std::sqrt(mat));
+            surface.push_back(VolQuote{strike, mat, sigma});
+        }
+    }
+    const std::vector<double> prices = HestonCalibrator(S0, r, surface).modelPrices(truth);
+    for (std::size_t q = 0; q < surface.size(); ++q)
+        surface[q].impliedVol = impliedVol(prices[q], S0, surface[q].strike, r, surface[q].maturity);
+
+    HestonCalibrator calibrator(S0, r, surface);
+    const HestonModel yesterday(r, 2.1, 0.048, 0.52, -0.68, 42);
+
+    std::cout << std::left << std::setw(8) << "Start" << std::right
+              << std::setw(10) << "kappa" << std::setw(10) << "theta"
+              << std::setw(10) << "xi" << std::setw(10) << "rho"
+              << std::setw(12) << "RMSE" << std::setw(8) << "Iter"
+              << std::setw(8) << "Conv" << std::setw(10) << "Time (ms)" << "\n";
+    std::cout << std::left << std::setw(8) << "truth" << std::right << std::fixed
+              << std::setprecision(4)
+              << std::setw(10) << truth.kappa << std::setw(10) << truth.theta
+              << std::setw(10) << truth.xi << std::setw(10) << truth.rho << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+    CalibrationResult cold = calibrator.calibrate(HestonParams{1.0, 0.03, 0.3, -0.3});
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printCalibration("cold", cold, ms);
+
+    start = std::chrono::steady_clock::now();
+    CalibrationResult warm = calibrator.calibrate(yesterday);
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printCalibration("warm", warm, ms);
+    return 0;
+}
+
+// Run découpé en shards : Asian call sous Black-Scholes, avec delta.
+//   pricing_test shard <index> <count> <file>   simule un shard
+//   pricing_test reduce <file>...               fusionne les shards
+//   pricing_test single                         même run en un seul processus
+static int shardedRun(int argc, char* argv[]) {
+    BSModel model(r, sigma);
+    AsianCallOption option(K, T);
+    PricingMC mc(option, model, nPaths, nSteps, S0);
+    mc.deltaBump = 0.01;
+
+    const std::string mode = argv[1];
+    if (mode == "shard" && argc == 5) {
+        MCShard shard = mc.simulateShard(std::atoi(argv[2]), std::atoi(argv[3]));
+        writeShard(shard, argv[4]);
+        return 0;
+    }
+    if (mode == "reduce" && argc >= 3) {
+        std::vector<MCShard> shards;
+        for (int i = 2; i < argc; ++i)
+            shards.push_back(readShard(argv[i]));
+        printResult(reduceShards(shards));
+        return 0;
+    }
+    if (mode == "single" && argc == 2) {
+        printResult(mc.run());
+        return 0;
+    }
+
+    std::cerr << "usage: " << argv[0] << " [shard <index> <count> <file> | reduce <file>... | single | pde | multi | calibrate]\n";
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc == 1)
+            return precisionReport();
+        if (argc == 2 && std::string(argv[1]) == "pde")
+            return pdeReport();
+        if (argc == 2 && std::string(argv[1]) == "multi")
+            return multiReport();
+        if (argc == 2 && std::string(argv[1]) == "calibrate")
+            return calibrationReport();
+        return shardedRun(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
 }